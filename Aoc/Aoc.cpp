@@ -0,0 +1,6 @@
+#include "Harness.h"
+
+int main(int InArgc, char* InArgv[])
+{
+    return Aoc::RunHarness(InArgc, InArgv);
+}
@@ -0,0 +1,376 @@
+#include "Harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#include "Parallel.h"
+#include "SelfTests.h"
+
+namespace Aoc
+{
+
+namespace
+{
+
+struct FRunOptions
+{
+    int32_t Day = 0;   // 0 runs every registered day
+    int32_t Part = 0;  // 0 runs both parts
+    int32_t WarmupRuns = 0;
+    int32_t MeasuredRuns = 1;
+    std::string Variant;  // empty runs the registered solvers only
+    bool bRunsAllVariants = false;
+    bool bRunsSelfTests = false;
+    std::vector<std::string> InputOverrides;
+    std::optional<int64_t> InputParameter;  // Parameter of the --input files
+};
+
+struct FTimingStats
+{
+    double MinMicroseconds = 0;
+    double MedianMicroseconds = 0;
+    double P99Microseconds = 0;
+};
+
+std::vector<FDay>& GetMutableDays()
+{
+    static std::vector<FDay> days;
+    return days;
+}
+
+struct FCounters
+{
+    std::mutex Mutex;
+    std::vector<std::pair<std::string, int64_t>> Values;
+};
+
+FCounters& GetCounters()
+{
+    static FCounters counters;
+    return counters;
+}
+
+void ClearCounters()
+{
+    FCounters& counters = GetCounters();
+    std::lock_guard lock(counters.Mutex);
+    counters.Values.clear();
+}
+
+void PrintCounters()
+{
+    FCounters& counters = GetCounters();
+    std::lock_guard lock(counters.Mutex);
+    for (const auto& [name, value] : counters.Values)
+        std::printf("  %-16s %lld\n", name.c_str(), static_cast<long long>(value));
+}
+
+std::vector<FVariant>& GetMutableVariants()
+{
+    static std::vector<FVariant> variants;
+    return variants;
+}
+
+void PrintUsage(const char* InProgramName)
+{
+    std::printf("Usage: %s [--day N] [--part 1|2] [--variant NAME | --all-variants] [--threads N] [--warmup N]"
+        " [--reps N] [--input FILE]... [--parameter N] [--self-test]\n"
+        "  --day N        only run day N (default: all registered days)\n"
+        "  --part P       only solve part P (default: both)\n"
+        "  --variant NAME only run the solver variant NAME, \"default\" is the registered solver\n"
+        "                 (default: only the registered solver)\n"
+        "  --all-variants run the registered solver followed by every variant\n"
+        "  --threads N    worker threads for parallel solvers (default: hardware concurrency)\n"
+        "  --warmup N     unmeasured runs of every stage before measuring (default: 0)\n"
+        "  --reps N       measured runs of every stage (default: 1)\n"
+        "  --input FILE   run on FILE instead of the day's registered inputs, requires --day\n"
+        "  --parameter N  puzzle parameter of the --input files, like Day08's connection count\n"
+        "  --self-test    run the checks of the shared code instead of any day\n",
+        InProgramName);
+}
+
+bool ParseInt(const char* InText, int32_t& OutValue)
+{
+    char* end = nullptr;
+    const long value = std::strtol(InText, &end, 10);
+    if (end == InText || *end != '\0')
+        return false;
+    OutValue = static_cast<int32_t>(value);
+    return true;
+}
+
+bool ParseOptions(int InArgc, char* InArgv[], FRunOptions& OutOptions)
+{
+    for (int argIndex = 1; argIndex < InArgc; ++argIndex)
+    {
+        const char* arg = InArgv[argIndex];
+        const bool hasValue = argIndex + 1 < InArgc;
+        if (std::strcmp(arg, "--day") == 0 && hasValue)
+        {
+            if (!ParseInt(InArgv[++argIndex], OutOptions.Day))
+                return false;
+        }
+        else if (std::strcmp(arg, "--part") == 0 && hasValue)
+        {
+            if (!ParseInt(InArgv[++argIndex], OutOptions.Part) || OutOptions.Part < 1 || OutOptions.Part > 2)
+                return false;
+        }
+        else if (std::strcmp(arg, "--variant") == 0 && hasValue)
+        {
+            OutOptions.Variant = InArgv[++argIndex];
+        }
+        else if (std::strcmp(arg, "--all-variants") == 0)
+        {
+            OutOptions.bRunsAllVariants = true;
+        }
+        else if (std::strcmp(arg, "--self-test") == 0)
+        {
+            OutOptions.bRunsSelfTests = true;
+        }
+        else if (std::strcmp(arg, "--threads") == 0 && hasValue)
+        {
+            int32_t workerCount = 0;
+            if (!ParseInt(InArgv[++argIndex], workerCount) || workerCount < 1)
+                return false;
+            SetWorkerCount(workerCount);
+        }
+        else if (std::strcmp(arg, "--warmup") == 0 && hasValue)
+        {
+            if (!ParseInt(InArgv[++argIndex], OutOptions.WarmupRuns) || OutOptions.WarmupRuns < 0)
+                return false;
+        }
+        else if (std::strcmp(arg, "--reps") == 0 && hasValue)
+        {
+            if (!ParseInt(InArgv[++argIndex], OutOptions.MeasuredRuns) || OutOptions.MeasuredRuns < 1)
+                return false;
+        }
+        else if (std::strcmp(arg, "--input") == 0 && hasValue)
+        {
+            OutOptions.InputOverrides.emplace_back(InArgv[++argIndex]);
+        }
+        else if (std::strcmp(arg, "--parameter") == 0 && hasValue)
+        {
+            char* end = nullptr;
+            const char* text = InArgv[++argIndex];
+            OutOptions.InputParameter = std::strtoll(text, &end, 10);
+            if (end == text || *end != '\0')
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (OutOptions.bRunsAllVariants && !OutOptions.Variant.empty())
+        return false;
+    if (!OutOptions.Variant.empty() && OutOptions.Variant != "default")
+    {
+        const std::vector<FVariant>& variants = GetRegisteredVariants();
+        const bool bIsKnown = std::any_of(variants.begin(), variants.end(), [&](const FVariant& InVariant)
+        {
+            return InVariant.Name == OutOptions.Variant;
+        });
+        if (!bIsKnown)
+            return false;
+    }
+    return OutOptions.InputOverrides.empty() || OutOptions.Day != 0;
+}
+
+FTimingStats CalculateStats(std::vector<double> InSamples)
+{
+    std::sort(InSamples.begin(), InSamples.end());
+    FTimingStats stats;
+    stats.MinMicroseconds = InSamples.front();
+    stats.MedianMicroseconds = InSamples[InSamples.size() / 2];
+    const size_t p99Index = static_cast<size_t>(std::ceil(InSamples.size() * 0.99)) - 1;
+    stats.P99Microseconds = InSamples[std::min(p99Index, InSamples.size() - 1)];
+    return stats;
+}
+
+// Runs InStage WarmupRuns + MeasuredRuns times and returns the timings of the measured runs.
+template <typename TStage>
+FTimingStats MeasureStage(const FRunOptions& InOptions, TStage&& InStage)
+{
+    for (int32_t run = 0; run < InOptions.WarmupRuns; ++run)
+        InStage();
+
+    std::vector<double> samples;
+    samples.reserve(InOptions.MeasuredRuns);
+    for (int32_t run = 0; run < InOptions.MeasuredRuns; ++run)
+    {
+        ClearCounters();
+        const auto start = std::chrono::steady_clock::now();
+        InStage();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return CalculateStats(std::move(samples));
+}
+
+void PrintStats(const char* InStageName, const FTimingStats& InStats, int32_t InRuns)
+{
+    std::printf("  %-16s min %12.1fus  median %12.1fus  p99 %12.1fus  (%d runs)\n",
+        InStageName, InStats.MinMicroseconds, InStats.MedianMicroseconds, InStats.P99Microseconds, InRuns);
+}
+
+// Returns false when the result is known to be wrong. InVariantName is null for the registered solver.
+bool RunPart(const FRunOptions& InOptions, int32_t InPart, const char* InVariantName,
+    const std::function<int64_t(const void*)>& InSolve, const void* InParsed, const std::optional<int64_t>& InExpected)
+{
+    int64_t result = 0;
+    const FTimingStats stats = MeasureStage(InOptions, [&]() { result = InSolve(InParsed); });
+
+    const std::string variantSuffix = InVariantName != nullptr ? std::string(" ") + InVariantName : std::string();
+    const bool isCorrect = !InExpected.has_value() || result == *InExpected;
+    if (InExpected.has_value())
+    {
+        std::printf("Result part %d%s: %s%lld%s which is %s%s%s\n", InPart, variantSuffix.c_str(),
+            ANSI_BOLD_UNDERLINE, static_cast<long long>(result), ANSI_RESET,
+            ANSI_BOLD_UNDERLINE, isCorrect ? "Correct" : "Incorrect", ANSI_RESET);
+    }
+    else
+    {
+        std::printf("Result part %d%s: %s%lld%s\n", InPart, variantSuffix.c_str(),
+            ANSI_BOLD_UNDERLINE, static_cast<long long>(result), ANSI_RESET);
+    }
+    const std::string stageName = std::string(InPart == 1 ? "Part 1" : "Part 2") + variantSuffix;
+    PrintStats(stageName.c_str(), stats, InOptions.MeasuredRuns);
+    PrintCounters();
+    return isCorrect;
+}
+
+bool RunParts(const FRunOptions& InOptions, const FDay& InDay, int32_t InPart, const void* InParsed,
+    const std::optional<int64_t>& InExpected)
+{
+    bool allCorrect = true;
+    if (InOptions.Variant.empty() || InOptions.Variant == "default")
+        allCorrect &= RunPart(InOptions, InPart, nullptr, InPart == 1 ? InDay.SolvePart1 : InDay.SolvePart2,
+            InParsed, InExpected);
+    for (const FVariant& variant : GetRegisteredVariants())
+    {
+        if (variant.Day != InDay.Number || variant.Part != InPart)
+            continue;
+        if (!InOptions.bRunsAllVariants && InOptions.Variant != variant.Name)
+            continue;
+        allCorrect &= RunPart(InOptions, InPart, variant.Name.c_str(), variant.Solve, InParsed, InExpected);
+    }
+    return allCorrect;
+}
+
+bool RunInput(const FRunOptions& InOptions, const FDay& InDay, const FPuzzleInput& InInput)
+{
+    std::printf("Day %02d - Result for %s\n", InDay.Number, InInput.FileName.c_str());
+    if (!std::filesystem::exists(InInput.FileName))
+    {
+        std::printf("  Skipped, input file not found\n");
+        return true;
+    }
+
+    std::shared_ptr<const void> parsed;
+    const FTimingStats parseStats = MeasureStage(InOptions, [&]()
+    {
+        parsed.reset();
+        parsed = InDay.Parse(InInput.FileName, InInput.Parameter);
+    });
+    PrintStats("Parse", parseStats, InOptions.MeasuredRuns);
+    PrintCounters();
+
+    bool allCorrect = true;
+    if (InOptions.Part == 0 || InOptions.Part == 1)
+        allCorrect &= RunParts(InOptions, InDay, 1, parsed.get(), InInput.Part1Expected);
+    if (InOptions.Part == 0 || InOptions.Part == 2)
+        allCorrect &= RunParts(InOptions, InDay, 2, parsed.get(), InInput.Part2Expected);
+    return allCorrect;
+}
+
+}
+
+void RegisterDay(FDay InDay)
+{
+    std::vector<FDay>& days = GetMutableDays();
+    days.push_back(std::move(InDay));
+    std::sort(days.begin(), days.end(), [](const FDay& InLHS, const FDay& InRHS)
+    {
+        return InLHS.Number < InRHS.Number;
+    });
+}
+
+const std::vector<FDay>& GetRegisteredDays()
+{
+    return GetMutableDays();
+}
+
+void SetCounter(const std::string& InName, int64_t InValue)
+{
+    FCounters& counters = GetCounters();
+    std::lock_guard lock(counters.Mutex);
+    for (auto& [name, value] : counters.Values)
+    {
+        if (name == InName)
+        {
+            value = InValue;
+            return;
+        }
+    }
+    counters.Values.emplace_back(InName, InValue);
+}
+
+void RegisterVariant(FVariant InVariant)
+{
+    GetMutableVariants().push_back(std::move(InVariant));
+}
+
+const std::vector<FVariant>& GetRegisteredVariants()
+{
+    return GetMutableVariants();
+}
+
+int RunHarness(int InArgc, char* InArgv[])
+{
+    FRunOptions options;
+    if (!ParseOptions(InArgc, InArgv, options))
+    {
+        PrintUsage(InArgv[0]);
+        return 2;
+    }
+    if (options.bRunsSelfTests)
+    {
+        std::printf("Self tests\n");
+        return RunSelfTests() ? 0 : 1;
+    }
+
+    bool foundDay = false;
+    bool allCorrect = true;
+    for (const FDay& day : GetRegisteredDays())
+    {
+        if (options.Day != 0 && day.Number != options.Day)
+            continue;
+        foundDay = true;
+
+        if (options.InputOverrides.empty())
+        {
+            for (const FPuzzleInput& input : day.Inputs)
+                allCorrect &= RunInput(options, day, input);
+        }
+        else
+        {
+            for (const std::string& fileName : options.InputOverrides)
+                allCorrect &= RunInput(options, day, FPuzzleInput{fileName, std::nullopt, std::nullopt, options.InputParameter});
+        }
+    }
+
+    if (!foundDay)
+    {
+        std::printf("Day %d is not registered\n", options.Day);
+        return 2;
+    }
+    return allCorrect ? 0 : 1;
+}
+
+}
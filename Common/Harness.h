@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Aoc
+{
+
+inline const char* ANSI_BOLD_UNDERLINE = "\033[1m\033[4m";
+inline const char* ANSI_RESET = "\033[0m";
+
+struct FPuzzleInput
+{
+    std::string FileName;
+    std::optional<int64_t> Part1Expected;
+    std::optional<int64_t> Part2Expected;
+    // Puzzle value the file doesn't hold, like a step count the example shrinks
+    std::optional<int64_t> Parameter = std::nullopt;
+};
+
+// Type-erased description of one day. Parse turns an input file into the day's parsed state,
+// the solvers only ever see that state so parse and solve can be timed separately.
+struct FDay
+{
+    int32_t Number = 0;
+    std::vector<FPuzzleInput> Inputs;
+    std::function<std::shared_ptr<const void>(const std::string&, const std::optional<int64_t>&)> Parse;
+    std::function<int64_t(const void*)> SolvePart1;
+    std::function<int64_t(const void*)> SolvePart2;
+};
+
+// Alternative solver for one part of a day, timed and checked like the registered solver when picked with
+// --variant NAME or --all-variants.
+struct FVariant
+{
+    int32_t Day = 0;
+    int32_t Part = 0;
+    std::string Name;
+    std::function<int64_t(const void*)> Solve;
+};
+
+// Named values a solver reports next to its timings, like the number of rounds it needed. Setting a
+// counter again overwrites it, the values of the last measured run are printed after the stage.
+void SetCounter(const std::string& InName, int64_t InValue);
+
+void RegisterDay(FDay InDay);
+const std::vector<FDay>& GetRegisteredDays();
+
+void RegisterVariant(FVariant InVariant);
+const std::vector<FVariant>& GetRegisteredVariants();
+
+// Entry point of the aoc runner, see PrintUsage in Harness.cpp for the command line.
+int RunHarness(int InArgc, char* InArgv[]);
+
+// Registers a day at static initialisation time:
+//     static const Aoc::TDayRegistrar Registrar(7, &Parse, &SolvePart1, &SolvePart2, {...});
+template <typename TParsed>
+class TDayRegistrar
+{
+public:
+    TDayRegistrar(int32_t InNumber,
+        TParsed (*InParse)(const std::string&),
+        int64_t (*InSolvePart1)(const TParsed&),
+        int64_t (*InSolvePart2)(const TParsed&),
+        std::vector<FPuzzleInput> InInputs)
+    {
+        FDay day;
+        day.Number = InNumber;
+        day.Inputs = std::move(InInputs);
+        day.Parse = [InParse](const std::string& InFileName, const std::optional<int64_t>&)
+            -> std::shared_ptr<const void>
+        {
+            return std::make_shared<const TParsed>(InParse(InFileName));
+        };
+        Register(std::move(day), InSolvePart1, InSolvePart2);
+    }
+
+    // For days whose Parse also takes the input's Parameter
+    TDayRegistrar(int32_t InNumber,
+        TParsed (*InParse)(const std::string&, const std::optional<int64_t>&),
+        int64_t (*InSolvePart1)(const TParsed&),
+        int64_t (*InSolvePart2)(const TParsed&),
+        std::vector<FPuzzleInput> InInputs)
+    {
+        FDay day;
+        day.Number = InNumber;
+        day.Inputs = std::move(InInputs);
+        day.Parse = [InParse](const std::string& InFileName, const std::optional<int64_t>& InParameter)
+            -> std::shared_ptr<const void>
+        {
+            return std::make_shared<const TParsed>(InParse(InFileName, InParameter));
+        };
+        Register(std::move(day), InSolvePart1, InSolvePart2);
+    }
+
+private:
+    static void Register(FDay InDay, int64_t (*InSolvePart1)(const TParsed&), int64_t (*InSolvePart2)(const TParsed&))
+    {
+        InDay.SolvePart1 = [InSolvePart1](const void* InParsed)
+        {
+            return InSolvePart1(*static_cast<const TParsed*>(InParsed));
+        };
+        InDay.SolvePart2 = [InSolvePart2](const void* InParsed)
+        {
+            return InSolvePart2(*static_cast<const TParsed*>(InParsed));
+        };
+        RegisterDay(std::move(InDay));
+    }
+};
+
+// Registers an alternative solver for one part, InSolve has to take the same parsed type as the
+// day's registered solvers:
+//     static const Aoc::TVariantRegistrar ParallelPart1(1, 1, "parallel", &SolvePart1Parallel);
+template <typename TParsed>
+class TVariantRegistrar
+{
+public:
+    TVariantRegistrar(int32_t InDay, int32_t InPart, std::string InName, int64_t (*InSolve)(const TParsed&))
+    {
+        FVariant variant;
+        variant.Day = InDay;
+        variant.Part = InPart;
+        variant.Name = std::move(InName);
+        variant.Solve = [InSolve](const void* InParsed)
+        {
+            return InSolve(*static_cast<const TParsed*>(InParsed));
+        };
+        RegisterVariant(std::move(variant));
+    }
+};
+
+}
@@ -0,0 +1,203 @@
+#include "Input.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Aoc
+{
+
+FMappedFile::FMappedFile(const std::string& InFileName)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(InFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+    FileHandle = file;
+    bIsOpen = true;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return;
+    }
+    MappingHandle = mapping;
+    Data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (Data == nullptr)
+    {
+        Close();
+        return;
+    }
+    Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    FileDescriptor = open(InFileName.c_str(), O_RDONLY);
+    if (FileDescriptor < 0)
+        return;
+    bIsOpen = true;
+
+    struct stat fileStat;
+    if (fstat(FileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+        return;
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+    if (mapped == MAP_FAILED)
+    {
+        Close();
+        return;
+    }
+    madvise(mapped, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+    Data = static_cast<const char*>(mapped);
+    Size = static_cast<size_t>(fileStat.st_size);
+#endif
+}
+
+FMappedFile::~FMappedFile()
+{
+    Close();
+}
+
+FMappedFile::FMappedFile(FMappedFile&& InOther) noexcept
+{
+    *this = std::move(InOther);
+}
+
+FMappedFile& FMappedFile::operator=(FMappedFile&& InOther) noexcept
+{
+    if (this != &InOther)
+    {
+        Close();
+        Data = std::exchange(InOther.Data, nullptr);
+        Size = std::exchange(InOther.Size, 0);
+        bIsOpen = std::exchange(InOther.bIsOpen, false);
+#ifdef _WIN32
+        FileHandle = std::exchange(InOther.FileHandle, nullptr);
+        MappingHandle = std::exchange(InOther.MappingHandle, nullptr);
+#else
+        FileDescriptor = std::exchange(InOther.FileDescriptor, -1);
+#endif
+    }
+    return *this;
+}
+
+void FMappedFile::Close()
+{
+#ifdef _WIN32
+    if (Data != nullptr)
+        UnmapViewOfFile(Data);
+    if (MappingHandle != nullptr)
+        CloseHandle(MappingHandle);
+    if (FileHandle != nullptr)
+        CloseHandle(FileHandle);
+    MappingHandle = nullptr;
+    FileHandle = nullptr;
+#else
+    if (Data != nullptr)
+        munmap(const_cast<char*>(Data), Size);
+    if (FileDescriptor >= 0)
+        close(FileDescriptor);
+    FileDescriptor = -1;
+#endif
+    Data = nullptr;
+    Size = 0;
+    bIsOpen = false;
+}
+
+bool FLineReader::Next(std::string_view& OutLine)
+{
+    if (bIsDone || Remaining.empty())
+        return false;
+
+    const size_t lineEnd = Remaining.find('\n');
+    if (lineEnd == std::string_view::npos)
+    {
+        OutLine = Remaining;
+        bIsDone = true;
+    }
+    else
+    {
+        OutLine = Remaining.substr(0, lineEnd);
+        Remaining.remove_prefix(lineEnd + 1);
+    }
+    if (!OutLine.empty() && OutLine.back() == '\r')
+        OutLine.remove_suffix(1);
+    return true;
+}
+
+std::vector<std::string_view> SplitLines(std::string_view InText)
+{
+    std::vector<std::string_view> lines;
+    lines.reserve(std::count(InText.begin(), InText.end(), '\n') + 1);
+    FLineReader reader(InText);
+    std::string_view line;
+    while (reader.Next(line))
+        lines.push_back(line);
+    return lines;
+}
+
+std::vector<std::string_view> SplitFields(std::string_view InText, std::string_view InDelimiters)
+{
+    std::vector<std::string_view> fields;
+    size_t fieldStart = InText.find_first_not_of(InDelimiters);
+    while (fieldStart != std::string_view::npos)
+    {
+        const size_t fieldEnd = InText.find_first_of(InDelimiters, fieldStart);
+        if (fieldEnd == std::string_view::npos)
+        {
+            fields.push_back(InText.substr(fieldStart));
+            break;
+        }
+        fields.push_back(InText.substr(fieldStart, fieldEnd - fieldStart));
+        fieldStart = InText.find_first_not_of(InDelimiters, fieldEnd);
+    }
+    return fields;
+}
+
+std::string_view Trim(std::string_view InText)
+{
+    const size_t first = InText.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos)
+        return {};
+    const size_t last = InText.find_last_not_of(" \t\r\n");
+    return InText.substr(first, last - first + 1);
+}
+
+FGridView::FGridView(std::vector<std::string_view> InRows)
+    : Rows(std::move(InRows))
+{
+    for (std::string_view row : Rows)
+        Width = std::max(Width, static_cast<int32_t>(row.size()));
+}
+
+FInputLines ReadLines(const std::string& InFileName)
+{
+    FInputLines input;
+    input.File = FMappedFile(InFileName);
+    input.Lines = SplitLines(input.File.GetContents());
+    return input;
+}
+
+FInputGrid ReadGrid(const std::string& InFileName)
+{
+    FInputGrid input;
+    input.File = FMappedFile(InFileName);
+    input.Grid = FGridView(SplitLines(input.File.GetContents()));
+    return input;
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Aoc
+{
+
+// Read-only memory mapping of a whole input file. Everything handed out as a string_view points
+// straight into the mapping, so the views stay valid for as long as the FMappedFile lives (moving it
+// keeps the mapping where it is).
+class FMappedFile
+{
+public:
+    FMappedFile() = default;
+    explicit FMappedFile(const std::string& InFileName);
+    ~FMappedFile();
+
+    FMappedFile(const FMappedFile&) = delete;
+    FMappedFile& operator=(const FMappedFile&) = delete;
+    FMappedFile(FMappedFile&& InOther) noexcept;
+    FMappedFile& operator=(FMappedFile&& InOther) noexcept;
+
+    bool IsOpen() const { return bIsOpen; }
+    std::string_view GetContents() const { return std::string_view(Data, Size); }
+
+private:
+    void Close();
+
+    const char* Data = nullptr;
+    size_t Size = 0;
+    bool bIsOpen = false;
+#ifdef _WIN32
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+#else
+    int FileDescriptor = -1;
+#endif
+};
+
+// Walks InText one line at a time without copying. Handles \n and \r\n endings and, unlike a
+// getline/eof loop, does not produce an empty record after a trailing newline.
+class FLineReader
+{
+public:
+    explicit FLineReader(std::string_view InText) : Remaining(InText) {}
+
+    bool Next(std::string_view& OutLine);
+
+private:
+    std::string_view Remaining;
+    bool bIsDone = false;
+};
+
+std::vector<std::string_view> SplitLines(std::string_view InText);
+
+// Splits InText on any of InDelimiters. Empty fields are skipped, so runs of delimiters act as one.
+std::vector<std::string_view> SplitFields(std::string_view InText, std::string_view InDelimiters);
+
+std::string_view Trim(std::string_view InText);
+
+template <typename T>
+T ToNumber(std::string_view InText)
+{
+    InText = Trim(InText);
+    T value{};
+    std::from_chars(InText.data(), InText.data() + InText.size(), value);
+    return value;
+}
+
+// Rows of a character grid that live in a mapped file, rows may differ in length.
+class FGridView
+{
+public:
+    FGridView() = default;
+    explicit FGridView(std::vector<std::string_view> InRows);
+
+    int32_t GetWidth() const { return Width; }
+    int32_t GetHeight() const { return static_cast<int32_t>(Rows.size()); }
+    std::string_view GetRow(int32_t InY) const { return Rows[InY]; }
+    const std::vector<std::string_view>& GetRows() const { return Rows; }
+
+    // Cells outside of a (short) row read as InOutside
+    char At(int32_t InX, int32_t InY, char InOutside = ' ') const
+    {
+        const std::string_view row = Rows[InY];
+        return InX >= 0 && InX < static_cast<int32_t>(row.size()) ? row[InX] : InOutside;
+    }
+
+private:
+    std::vector<std::string_view> Rows;
+    int32_t Width = 0;
+};
+
+// Parsed inputs that keep the mapping alive next to the views that point into it
+struct FInputLines
+{
+    FMappedFile File;
+    std::vector<std::string_view> Lines;
+};
+
+struct FInputGrid
+{
+    FMappedFile File;
+    FGridView Grid;
+};
+
+FInputLines ReadLines(const std::string& InFileName);
+FInputGrid ReadGrid(const std::string& InFileName);
+
+}
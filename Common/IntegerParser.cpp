@@ -0,0 +1,150 @@
+#include "IntegerParser.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if AOC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Aoc
+{
+
+namespace
+{
+
+bool IsDigit(char InChar)
+{
+    return static_cast<unsigned char>(InChar - '0') < 10;
+}
+
+#if AOC_HAS_SSE2
+// Bit i is set when InData[i] is an ASCII digit, reads 64 bytes
+uint64_t DigitMask64(const char* InData)
+{
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    uint64_t mask = 0;
+    for (int block = 0; block < 4; ++block)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InData + block * 16));
+        const __m128i offset = _mm_sub_epi8(bytes, zero);
+        const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(offset, nine), offset);
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(isDigit))) << (block * 16);
+    }
+    return mask;
+}
+#endif
+
+// SWAR check and conversion of 8 ASCII digits loaded little endian
+bool IsEightDigits(uint64_t InChunk)
+{
+    return ((InChunk & 0xF0F0F0F0F0F0F0F0) | (((InChunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+        == 0x3333333333333333;
+}
+
+uint32_t ParseEightDigits(uint64_t InChunk)
+{
+    constexpr uint64_t mask = 0x000000FF000000FF;
+    constexpr uint64_t multiplier1 = 100 + (1000000ULL << 32);
+    constexpr uint64_t multiplier2 = 1 + (10000ULL << 32);
+    InChunk -= 0x3030303030303030;
+    InChunk = (InChunk * 10) + (InChunk >> 8);
+    return static_cast<uint32_t>((((InChunk & mask) * multiplier1) + (((InChunk >> 16) & mask) * multiplier2)) >> 32);
+}
+
+}
+
+size_t FIntegerScanner::ReadValues(int64_t* OutValues, size_t InCapacity, bool InbUseSimd)
+{
+    size_t count = 0;
+    while (count < InCapacity)
+    {
+        const size_t start = FindNextDigit(Position, InbUseSimd);
+        if (start == std::string_view::npos)
+        {
+            Position = Text.size();
+            break;
+        }
+        OutValues[count++] = ReadNumberAt(start);
+    }
+    return count;
+}
+
+size_t FIntegerScanner::FindNextDigit(size_t InFrom, bool InbUseSimd) const
+{
+    // Delimiters are usually a single character, so look at a few bytes before going wide
+    const size_t scalarEnd = std::min(Text.size(), InFrom + 4);
+    for (; InFrom < scalarEnd; ++InFrom)
+    {
+        if (IsDigit(Text[InFrom]))
+            return InFrom;
+    }
+
+#if AOC_HAS_SSE2
+    if (InbUseSimd)
+    {
+        for (; InFrom + 64 <= Text.size(); InFrom += 64)
+        {
+            const uint64_t digits = DigitMask64(Text.data() + InFrom);
+            if (digits != 0)
+                return InFrom + std::countr_zero(digits);
+        }
+    }
+#else
+    (void)InbUseSimd;
+#endif
+
+    for (; InFrom < Text.size(); ++InFrom)
+    {
+        if (IsDigit(Text[InFrom]))
+            return InFrom;
+    }
+    return std::string_view::npos;
+}
+
+int64_t FIntegerScanner::ReadNumberAt(size_t InStart)
+{
+    size_t position = InStart;
+    int64_t value = 0;
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        while (position + 8 <= Text.size())
+        {
+            uint64_t chunk;
+            std::memcpy(&chunk, Text.data() + position, sizeof(chunk));
+            if (!IsEightDigits(chunk))
+                break;
+            value = value * 100000000 + ParseEightDigits(chunk);
+            position += 8;
+        }
+    }
+    while (position < Text.size() && IsDigit(Text[position]))
+    {
+        value = value * 10 + (Text[position] - '0');
+        ++position;
+    }
+    Position = position;
+
+    const bool isNegative = InStart > 0 && Text[InStart - 1] == '-'
+        && (InStart < 2 || !IsDigit(Text[InStart - 2]));
+    return isNegative ? -value : value;
+}
+
+void AppendIntegers(std::string_view InText, std::vector<int64_t>& OutValues)
+{
+    // Scan into a small local buffer so per-line calls do not over-allocate the output
+    constexpr size_t chunkSize = 256;
+    int64_t chunk[chunkSize];
+    FIntegerScanner scanner(InText);
+    size_t written = 0;
+    do
+    {
+        written = scanner.Read(chunk, chunkSize);
+        OutValues.insert(OutValues.end(), chunk, chunk + written);
+    }
+    while (written == chunkSize);
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Simd.h"
+
+namespace Aoc
+{
+
+// Pulls signed integers out of text where they are separated by arbitrary non-digit delimiters
+// ("11-22,95-115", "7,1", "(1,3) {3,5,4,7}", "12x5: 1 0 1"). A '-' right in front of a digit is a
+// sign unless it follows a digit itself, so "11-22" reads as 11 and 22 while "-5,-3" reads as -5 and -3.
+// Delimiter runs are skipped 64 bytes at a time using SSE2 digit masks, digits are assembled 8 at a time.
+class FIntegerScanner
+{
+public:
+    explicit FIntegerScanner(std::string_view InText) : Text(InText) {}
+
+    // Writes up to InCapacity values to OutValues and returns how many were written. Call again to
+    // continue where the previous call stopped, 0 means the text is exhausted.
+    size_t Read(int64_t* OutValues, size_t InCapacity) { return ReadValues(OutValues, InCapacity, AOC_HAS_SSE2 != 0); }
+    // Same as Read without the SIMD delimiter skipping, kept for benchmarking and non-x86 builds
+    size_t ReadScalar(int64_t* OutValues, size_t InCapacity) { return ReadValues(OutValues, InCapacity, false); }
+
+private:
+    size_t ReadValues(int64_t* OutValues, size_t InCapacity, bool InbUseSimd);
+    size_t FindNextDigit(size_t InFrom, bool InbUseSimd) const;
+    int64_t ReadNumberAt(size_t InStart);
+
+    std::string_view Text;
+    size_t Position = 0;
+};
+
+// Parses every integer in InText into the caller provided OutValues, returns the number written
+inline size_t ParseIntegers(std::string_view InText, int64_t* OutValues, size_t InCapacity)
+{
+    return FIntegerScanner(InText).Read(OutValues, InCapacity);
+}
+
+// Appends every integer in InText to OutValues
+void AppendIntegers(std::string_view InText, std::vector<int64_t>& OutValues);
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+namespace Aoc
+{
+
+// Disjoint ranges that can be changed one range at a time. Overlapping and touching ranges are coalesced on
+// insert, erase splits the ranges it cuts into. Every update is amortised O(log n) since a range is only
+// merged away once, and the number of covered ids is kept up to date so it is always available.
+class FDynamicIntervalSet
+{
+public:
+    // Adds the inclusive range [InStart, InEnd]
+    void Insert(int64_t InStart, int64_t InEnd)
+    {
+        auto range = Ranges.upper_bound(InStart);
+        if (range != Ranges.begin() && std::prev(range)->second >= InStart - 1)
+            --range;
+        while (range != Ranges.end() && range->first - 1 <= InEnd)
+        {
+            InStart = std::min(InStart, range->first);
+            InEnd = std::max(InEnd, range->second);
+            CoveredCount -= range->second - range->first + 1;
+            range = Ranges.erase(range);
+        }
+        Ranges.emplace_hint(range, InStart, InEnd);
+        CoveredCount += InEnd - InStart + 1;
+    }
+
+    // Removes the inclusive range [InStart, InEnd], whatever parts of it are covered
+    void Erase(int64_t InStart, int64_t InEnd)
+    {
+        auto range = Ranges.upper_bound(InStart);
+        if (range != Ranges.begin() && std::prev(range)->second >= InStart)
+            --range;
+        while (range != Ranges.end() && range->first <= InEnd)
+        {
+            const auto [start, end] = *range;
+            CoveredCount -= end - start + 1;
+            range = Ranges.erase(range);
+            if (start < InStart)
+            {
+                Ranges.emplace_hint(range, start, InStart - 1);
+                CoveredCount += InStart - start;
+            }
+            if (end > InEnd)
+            {
+                Ranges.emplace_hint(range, InEnd + 1, end);
+                CoveredCount += end - InEnd;
+            }
+        }
+    }
+
+    bool Contains(int64_t InValue) const
+    {
+        auto range = Ranges.upper_bound(InValue);
+        return range != Ranges.begin() && std::prev(range)->second >= InValue;
+    }
+
+    const std::map<int64_t, int64_t>& GetRanges() const { return Ranges; }
+    int64_t GetRangeCount() const { return static_cast<int64_t>(Ranges.size()); }
+    int64_t GetCoveredCount() const { return CoveredCount; }
+
+private:
+    std::map<int64_t, int64_t> Ranges;  // start -> inclusive end
+    int64_t CoveredCount = 0;
+};
+
+}
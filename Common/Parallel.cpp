@@ -0,0 +1,154 @@
+#include "Parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Aoc
+{
+
+namespace
+{
+
+std::atomic<int32_t> WorkerCount = 0;
+// Set on pool threads and on the thread that posted the running job, RunBlocks called from inside one of
+// its blocks would otherwise wait on PoolMutex or on the pool it is part of
+thread_local bool bIsRunningBlocks = false;
+
+// Workers sleep until a job is posted, then take blocks off a shared counter together with the thread
+// that posted it. Only one job runs at a time, RunBlocks holds PoolMutex while it waits.
+class FThreadPool
+{
+public:
+    explicit FThreadPool(int32_t InThreadCount)
+    {
+        Threads.reserve(InThreadCount);
+        for (int32_t thread = 0; thread < InThreadCount; ++thread)
+            Threads.emplace_back([this]() { WorkerLoop(); });
+    }
+
+    ~FThreadPool()
+    {
+        {
+            std::lock_guard lock(Mutex);
+            bIsStopping = true;
+        }
+        WakeWorkers.notify_all();
+        for (std::thread& thread : Threads)
+            thread.join();
+    }
+
+    size_t GetThreadCount() const { return Threads.size(); }
+
+    void Run(size_t InBlockCount, const std::function<void(size_t)>& InRunBlock)
+    {
+        {
+            std::lock_guard lock(Mutex);
+            RunBlock = &InRunBlock;
+            BlockCount = InBlockCount;
+            NextBlock = 0;
+            PendingBlocks = InBlockCount;
+            ++JobId;
+        }
+        WakeWorkers.notify_all();
+        RunAvailableBlocks();
+
+        std::unique_lock lock(Mutex);
+        JobDone.wait(lock, [this]() { return PendingBlocks == 0; });
+        RunBlock = nullptr;
+    }
+
+private:
+    void WorkerLoop()
+    {
+        bIsRunningBlocks = true;
+        uint64_t seenJobId = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(Mutex);
+                WakeWorkers.wait(lock, [&]() { return bIsStopping || JobId != seenJobId; });
+                if (bIsStopping)
+                    return;
+                seenJobId = JobId;
+            }
+            RunAvailableBlocks();
+        }
+    }
+
+    void RunAvailableBlocks()
+    {
+        while (true)
+        {
+            const std::function<void(size_t)>* runBlock;
+            size_t block;
+            {
+                std::lock_guard lock(Mutex);
+                if (RunBlock == nullptr || NextBlock >= BlockCount)
+                    return;
+                runBlock = RunBlock;
+                block = NextBlock++;
+            }
+            (*runBlock)(block);
+
+            std::lock_guard lock(Mutex);
+            if (--PendingBlocks == 0)
+                JobDone.notify_all();
+        }
+    }
+
+    std::vector<std::thread> Threads;
+    std::mutex Mutex;
+    std::condition_variable WakeWorkers;
+    std::condition_variable JobDone;
+    const std::function<void(size_t)>* RunBlock = nullptr;
+    size_t BlockCount = 0;
+    size_t NextBlock = 0;
+    size_t PendingBlocks = 0;
+    uint64_t JobId = 0;
+    bool bIsStopping = false;
+};
+
+std::mutex PoolMutex;
+std::unique_ptr<FThreadPool> Pool;
+
+}
+
+int32_t GetWorkerCount()
+{
+    const int32_t workerCount = WorkerCount.load(std::memory_order_relaxed);
+    if (workerCount > 0)
+        return workerCount;
+    return std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+}
+
+void SetWorkerCount(int32_t InWorkerCount)
+{
+    WorkerCount.store(std::max(1, InWorkerCount), std::memory_order_relaxed);
+}
+
+void RunBlocks(size_t InBlockCount, const std::function<void(size_t)>& InRunBlock)
+{
+    const size_t threadCount = static_cast<size_t>(GetWorkerCount()) - 1;
+    if (InBlockCount <= 1 || threadCount == 0 || bIsRunningBlocks)
+    {
+        for (size_t block = 0; block < InBlockCount; ++block)
+            InRunBlock(block);
+        return;
+    }
+
+    std::lock_guard lock(PoolMutex);
+    if (Pool == nullptr || Pool->GetThreadCount() != threadCount)
+    {
+        Pool.reset();
+        Pool = std::make_unique<FThreadPool>(static_cast<int32_t>(threadCount));
+    }
+    bIsRunningBlocks = true;
+    Pool->Run(InBlockCount, InRunBlock);
+    bIsRunningBlocks = false;
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace Aoc
+{
+
+// Worker threads used by the parallel solvers, defaults to the hardware concurrency
+int32_t GetWorkerCount();
+void SetWorkerCount(int32_t InWorkerCount);
+
+// Number of blocks to split InCount items into so that every block has at least InMinBlockSize items
+// and no worker gets more than one block
+inline size_t GetBlockCount(size_t InCount, size_t InMinBlockSize)
+{
+    const size_t maxBlocks = std::max<size_t>(1, InCount / std::max<size_t>(1, InMinBlockSize));
+    return std::min(maxBlocks, static_cast<size_t>(GetWorkerCount()));
+}
+
+// Runs InRunBlock(0 .. InBlockCount - 1) on a shared pool of GetWorkerCount() - 1 threads plus the calling
+// thread and returns once every block is done. Calls made from inside a block run serially.
+void RunBlocks(size_t InBlockCount, const std::function<void(size_t)>& InRunBlock);
+
+// Splits [0, InCount) into InBlockCount contiguous blocks and runs InBody(InBlock, InBegin, InEnd) for each
+// of them through RunBlocks
+template <typename TBody>
+void ParallelForBlocks(size_t InCount, size_t InBlockCount, TBody&& InBody)
+{
+    InBlockCount = std::max<size_t>(1, InBlockCount);
+    const auto blockBegin = [&](size_t InBlock) { return InCount * InBlock / InBlockCount; };
+    if (InBlockCount == 1)
+    {
+        InBody(size_t(0), blockBegin(0), blockBegin(1));
+        return;
+    }
+    RunBlocks(InBlockCount, [&](size_t InBlock) { InBody(InBlock, blockBegin(InBlock), blockBegin(InBlock + 1)); });
+}
+
+// Raises InOutValue to InCandidate unless another thread already stored something at least as large
+template <typename T>
+void AtomicMax(std::atomic<T>& InOutValue, T InCandidate)
+{
+    T current = InOutValue.load(std::memory_order_relaxed);
+    while (current < InCandidate && !InOutValue.compare_exchange_weak(current, InCandidate, std::memory_order_relaxed))
+    {
+    }
+}
+
+}
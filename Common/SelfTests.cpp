@@ -0,0 +1,130 @@
+#include "SelfTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "IntervalSet.h"
+#include "Parallel.h"
+
+namespace Aoc
+{
+
+namespace
+{
+
+// ParallelForBlocks from inside the blocks of another one, on the posting thread as well as on the pool.
+// A nested call that blocks on the pool never returns, so the check runs on its own thread and gives up
+// after a timeout.
+bool CheckNestedParallelForBlocks()
+{
+    constexpr size_t outerCount = 8;
+    constexpr size_t innerCount = 1000;
+    const int32_t previousWorkerCount = GetWorkerCount();
+    SetWorkerCount(4);
+
+    std::promise<int64_t> total;
+    std::future<int64_t> result = total.get_future();
+    std::thread([&total]()
+    {
+        std::atomic<int64_t> sum = 0;
+        ParallelForBlocks(outerCount, 4, [&](size_t, size_t InBegin, size_t InEnd)
+        {
+            for (size_t outer = InBegin; outer < InEnd; ++outer)
+            {
+                ParallelForBlocks(innerCount, 4, [&](size_t, size_t InInnerBegin, size_t InInnerEnd)
+                {
+                    for (size_t inner = InInnerBegin; inner < InInnerEnd; ++inner)
+                        sum += static_cast<int64_t>(inner);
+                });
+            }
+        });
+        total.set_value(sum);
+    }).detach();
+
+    if (result.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+    {
+        // The stuck threads would keep the pool from shutting down
+        std::printf("  nested ParallelForBlocks: deadlocked\n");
+        std::fflush(stdout);
+        std::_Exit(1);
+    }
+    SetWorkerCount(previousWorkerCount);
+
+    const int64_t expected = static_cast<int64_t>(outerCount * (innerCount * (innerCount - 1) / 2));
+    const int64_t sum = result.get();
+    std::printf("  nested ParallelForBlocks: %s\n", sum == expected ? "passed" : "wrong sum");
+    return sum == expected;
+}
+
+
+// Random inserts and erases on a small universe, after every one the ranges, the covered count and Contains
+// have to match a bitmap that applied the same updates
+bool CheckDynamicIntervalSet()
+{
+    constexpr int64_t universe = 512;
+    std::mt19937_64 random(2025);
+    std::uniform_int_distribution<int64_t> startDistribution(0, universe - 1);
+    std::uniform_int_distribution<int64_t> lengthDistribution(1, 64);
+    FDynamicIntervalSet ranges;
+    std::vector<bool> covered(universe, false);
+    for (int32_t update = 0; update < 20000; ++update)
+    {
+        const int64_t start = startDistribution(random);
+        const int64_t end = std::min(universe - 1, start + lengthDistribution(random) - 1);
+        const bool bIsInsert = random() % 3 != 0;
+        if (bIsInsert)
+            ranges.Insert(start, end);
+        else
+            ranges.Erase(start, end);
+        for (int64_t value = start; value <= end; ++value)
+            covered[value] = bIsInsert;
+
+        std::map<int64_t, int64_t> expectedRanges;
+        int64_t expectedCount = 0;
+        for (int64_t value = 0; value < universe; ++value)
+        {
+            if (ranges.Contains(value) != covered[value])
+            {
+                std::printf("  dynamic interval set: Contains(%lld) wrong after update %d\n",
+                    static_cast<long long>(value), update);
+                return false;
+            }
+            if (!covered[value])
+                continue;
+            ++expectedCount;
+            if (value > 0 && covered[value - 1])
+                expectedRanges.rbegin()->second = value;
+            else
+                expectedRanges.emplace(value, value);
+        }
+        if (ranges.GetRanges() != expectedRanges || ranges.GetCoveredCount() != expectedCount
+            || ranges.GetRangeCount() != static_cast<int64_t>(expectedRanges.size())
+            || ranges.Contains(-1) || ranges.Contains(universe))
+        {
+            std::printf("  dynamic interval set: ranges wrong after update %d\n", update);
+            return false;
+        }
+    }
+    std::printf("  dynamic interval set: passed\n");
+    return true;
+}
+
+}
+
+bool RunSelfTests()
+{
+    bool allPassed = true;
+    allPassed &= CheckNestedParallelForBlocks();
+    allPassed &= CheckDynamicIntervalSet();
+    return allPassed;
+}
+
+}
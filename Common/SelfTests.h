@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Aoc
+{
+
+// Checks of the shared infrastructure that no puzzle answer covers, run by aoc --self-test. Prints one line
+// per check and returns false when any of them failed.
+bool RunSelfTests();
+
+}
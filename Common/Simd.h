@@ -0,0 +1,15 @@
+#pragma once
+
+// SSE2 is part of x64, AVX2 has to be enabled by the compiler (/arch:AVX2, -mavx2).
+// Define AOC_DISABLE_SIMD to benchmark the scalar fallbacks.
+#if !defined(AOC_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define AOC_HAS_SSE2 1
+#else
+#define AOC_HAS_SSE2 0
+#endif
+
+#if !defined(AOC_DISABLE_SIMD) && defined(__AVX2__)
+#define AOC_HAS_AVX2 1
+#else
+#define AOC_HAS_AVX2 0
+#endif
@@ -1,47 +1,254 @@
-#include <fstream>
+#include <array>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
+#include "Parallel.h"
+#include "Simd.h"
 
-std::string Filename = "TestInput.txt";
-//std::string Filename = "Input.txt";
+#if AOC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Day01
+{
+
+struct FDialResult
+{
+    int64_t Part1Count = 0;
+    int64_t Part2Count = 0;
+};
+
+constexpr int32_t DialSize = 100;
+constexpr int32_t DialStart = 50;
 
 int32_t WrapTo99(int InCount) {
     return (InCount % 100 + 100) % 100;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+// Rotations are stored signed, L is negative and R positive
+std::vector<int32_t> Parse(const std::string& InFileName)
 {
-    std::ifstream inputFile;
-    inputFile.open(Filename);
-    std::string inputLine;
-    
-    int32_t currentNumber = 50;
-    int32_t part1Count = 0;
-    int32_t part2Count = 0;
+    Aoc::FMappedFile inputFile(InFileName);
+    Aoc::FLineReader lineReader(inputFile.GetContents());
+    std::string_view inputLine;
+    std::vector<int32_t> rotations;
 
-    while (inputFile.is_open() && !inputFile.eof())
+    while (lineReader.Next(inputLine))
     {
-        std::getline(inputFile, inputLine);
+        if (inputLine.empty())
+            continue;
         int32_t sign = inputLine[0] == 'L' ? -1 : 1;
-        int32_t value = std::atoi(inputLine.c_str() + 1);
-        
-        part2Count += value / 100;
+        int64_t value = 0;
+        Aoc::ParseIntegers(inputLine, &value, 1);
+        rotations.push_back(sign * static_cast<int32_t>(value));
+    }
+    return rotations;
+}
+
+FDialResult SimulateDial(const std::vector<int32_t>& InRotations)
+{
+    int32_t currentNumber = DialStart;
+    FDialResult result;
+
+    for (int32_t rotation : InRotations)
+    {
+        int32_t sign = rotation < 0 ? -1 : 1;
+        int32_t value = rotation * sign;
+
+        result.Part2Count += value / 100;
         int32_t wrappedDiff = (value * sign) % 100;
         const bool isOutsideOfRange = (currentNumber + wrappedDiff <= 0
             || currentNumber + wrappedDiff > 99);
         if (currentNumber != 0 && isOutsideOfRange)
-            part2Count++;
+            result.Part2Count++;
         currentNumber = WrapTo99(currentNumber + sign * value);
-        
+
         if (currentNumber == 0)
-            part1Count++;
+            result.Part1Count++;
     }
-    std::printf("Result part 1, ends at 0: %s%d%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET);
-    std::printf("Result part 2, Number of times past 0: %s%d%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET);
-    return 0;
+    return result;
+}
+
+// The effect of a run of rotations on the dial for every possible start position. The end position is
+// always start + Offset, so only the counts need a table. Two runs combine by looking up the second run's
+// counts at the first run's end position, which makes runs reducible in parallel.
+struct FDialTransform
+{
+    int32_t Offset = 0;
+    int64_t FullTurns = 0;                          // sum of value / 100, the same for every start
+    std::array<int64_t, DialSize> ZeroStops{};      // part 1 count per start position
+    std::array<int64_t, DialSize> ZeroCrossings{};  // part 2 count per start position, without FullTurns
+};
+
+// Position is relative to the start of the run. A rotation with wrapped diff d crosses or lands on zero from
+// current position c when c + d > 99 (c in [100 - d, 99]) or c + d <= 0 with c != 0 (c in [1, -d]). Those
+// current positions are a range of start positions, added to a difference table that is twice as long as
+// the dial so the range never has to be split.
+struct FDialTransformBuilder
+{
+    int32_t Position = 0;
+    int64_t FullTurns = 0;
+    std::array<int64_t, DialSize> StopHistogram{};
+    std::array<int64_t, DialSize * 2 + 1> CrossingDiff{};
+
+    void AddRotation(int32_t InWrappedDiff, int32_t InStep, int32_t InRangeBegin)
+    {
+        int32_t startBegin = InRangeBegin - Position;
+        startBegin += startBegin < 0 ? DialSize : 0;
+        const int32_t rangeLength = InWrappedDiff < 0 ? -InWrappedDiff : InWrappedDiff;
+        CrossingDiff[startBegin]++;
+        CrossingDiff[startBegin + rangeLength]--;
+
+        Position += InStep;
+        Position -= Position >= DialSize ? DialSize : 0;
+        StopHistogram[Position]++;
+    }
+
+    FDialTransform Finish() const
+    {
+        FDialTransform transform;
+        transform.Offset = Position;
+        transform.FullTurns = FullTurns;
+        int64_t crossings = 0;
+        std::array<int64_t, DialSize * 2> crossingCounts{};
+        for (int32_t index = 0; index < DialSize * 2; ++index)
+        {
+            crossings += CrossingDiff[index];
+            crossingCounts[index] = crossings;
+        }
+        for (int32_t start = 0; start < DialSize; ++start)
+        {
+            transform.ZeroStops[start] = StopHistogram[(DialSize - start) % DialSize];
+            transform.ZeroCrossings[start] = crossingCounts[start] + crossingCounts[start + DialSize];
+        }
+        return transform;
+    }
+};
+
+void AddRotationScalar(FDialTransformBuilder& InOutBuilder, int32_t InRotation)
+{
+    const int32_t value = InRotation < 0 ? -InRotation : InRotation;
+    const int32_t wrappedDiff = InRotation % DialSize;
+    InOutBuilder.FullTurns += value / DialSize;
+    InOutBuilder.AddRotation(wrappedDiff, WrapTo99(wrappedDiff), wrappedDiff > 0 ? DialSize - wrappedDiff : 1);
+}
+
+FDialTransform BuildDialTransform(const int32_t* InRotations, size_t InCount)
+{
+    FDialTransformBuilder builder;
+    size_t index = 0;
+#if AOC_HAS_SSE2
+    // value / 100, value % 100, WrapTo99 and the crossing range start four rotations at a time, only the
+    // position scan and the table updates stay scalar
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i dialSize = _mm_set1_epi32(DialSize);
+    const __m128i divideBy100 = _mm_set1_epi32(0x51EB851F);
+    __m128i fullTurns = zero;
+    alignas(16) int32_t wrappedDiffs[4];
+    alignas(16) int32_t steps[4];
+    alignas(16) int32_t rangeBegins[4];
+    for (; index + 4 <= InCount; index += 4)
+    {
+        const __m128i rotation = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InRotations + index));
+        const __m128i sign = _mm_srai_epi32(rotation, 31);
+        const __m128i value = _mm_sub_epi32(_mm_xor_si128(rotation, sign), sign);
+
+        // value / 100 == (value * 0x51EB851F) >> 37 for any 32 bit value
+        const __m128i evenQuotients = _mm_srli_epi64(_mm_mul_epu32(value, divideBy100), 37);
+        const __m128i oddQuotients = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(value, 32), divideBy100), 37);
+        const __m128i quotient = _mm_or_si128(evenQuotients, _mm_slli_epi64(oddQuotients, 32));
+        fullTurns = _mm_add_epi64(fullTurns, _mm_add_epi64(evenQuotients, oddQuotients));
+
+        const __m128i quotientTimes100 = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(quotient, 6),
+            _mm_slli_epi32(quotient, 5)), _mm_slli_epi32(quotient, 2));
+        const __m128i remainder = _mm_sub_epi32(value, quotientTimes100);
+        const __m128i wrappedDiff = _mm_sub_epi32(_mm_xor_si128(remainder, sign), sign);
+        const __m128i step = _mm_add_epi32(wrappedDiff, _mm_and_si128(_mm_srai_epi32(wrappedDiff, 31), dialSize));
+        const __m128i isPositive = _mm_cmpgt_epi32(wrappedDiff, zero);
+        const __m128i rangeBegin = _mm_or_si128(_mm_and_si128(isPositive, _mm_sub_epi32(dialSize, wrappedDiff)),
+            _mm_andnot_si128(isPositive, one));
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(wrappedDiffs), wrappedDiff);
+        _mm_store_si128(reinterpret_cast<__m128i*>(steps), step);
+        _mm_store_si128(reinterpret_cast<__m128i*>(rangeBegins), rangeBegin);
+        for (int32_t lane = 0; lane < 4; ++lane)
+            builder.AddRotation(wrappedDiffs[lane], steps[lane], rangeBegins[lane]);
+    }
+    alignas(16) int64_t fullTurnLanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(fullTurnLanes), fullTurns);
+    builder.FullTurns += fullTurnLanes[0] + fullTurnLanes[1];
+#endif
+    for (; index < InCount; ++index)
+        AddRotationScalar(builder, InRotations[index]);
+    return builder.Finish();
+}
+
+FDialTransform CombineDialTransforms(const FDialTransform& InFirst, const FDialTransform& InSecond)
+{
+    FDialTransform combined;
+    combined.Offset = (InFirst.Offset + InSecond.Offset) % DialSize;
+    combined.FullTurns = InFirst.FullTurns + InSecond.FullTurns;
+    for (int32_t start = 0; start < DialSize; ++start)
+    {
+        const int32_t middle = (start + InFirst.Offset) % DialSize;
+        combined.ZeroStops[start] = InFirst.ZeroStops[start] + InSecond.ZeroStops[middle];
+        combined.ZeroCrossings[start] = InFirst.ZeroCrossings[start] + InSecond.ZeroCrossings[middle];
+    }
+    return combined;
+}
+
+// Same result as SimulateDial, but every block of rotations is turned into a transform on its own thread
+FDialResult SimulateDialParallel(const std::vector<int32_t>& InRotations)
+{
+    constexpr size_t minBlockSize = 1 << 16;
+    const size_t blockCount = Aoc::GetBlockCount(InRotations.size(), minBlockSize);
+    std::vector<FDialTransform> transforms(blockCount);
+    Aoc::ParallelForBlocks(InRotations.size(), blockCount, [&](size_t InBlock, size_t InBegin, size_t InEnd)
+    {
+        transforms[InBlock] = BuildDialTransform(InRotations.data() + InBegin, InEnd - InBegin);
+    });
+
+    FDialTransform total = transforms[0];
+    for (size_t block = 1; block < blockCount; ++block)
+        total = CombineDialTransforms(total, transforms[block]);
+
+    FDialResult result;
+    result.Part1Count = total.ZeroStops[DialStart];
+    result.Part2Count = total.ZeroCrossings[DialStart] + total.FullTurns;
+    return result;
+}
+
+int64_t SolvePart1(const std::vector<int32_t>& InRotations)
+{
+    return SimulateDial(InRotations).Part1Count;
+}
+
+int64_t SolvePart2(const std::vector<int32_t>& InRotations)
+{
+    return SimulateDial(InRotations).Part2Count;
+}
+
+int64_t SolvePart1Parallel(const std::vector<int32_t>& InRotations)
+{
+    return SimulateDialParallel(InRotations).Part1Count;
+}
+
+int64_t SolvePart2Parallel(const std::vector<int32_t>& InRotations)
+{
+    return SimulateDialParallel(InRotations).Part2Count;
+}
+
+static const Aoc::TDayRegistrar Registrar(1, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day01/TestInput.txt", 3, 6},
+    {"Day01/Input.txt", std::nullopt, std::nullopt},
+});
+static const Aoc::TVariantRegistrar ParallelPart1(1, 1, "parallel", &SolvePart1Parallel);
+static const Aoc::TVariantRegistrar ParallelPart2(1, 2, "parallel", &SolvePart2Parallel);
+
 }
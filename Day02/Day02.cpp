@@ -1,12 +1,16 @@
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
 
-std::string Filename = "TestInput.txt";
-//std::string Filename = "Input.txt";
+namespace Day02
+{
 
 int64_t Part1Check(int64_t InValue)
 {
@@ -49,29 +53,149 @@ int64_t Part2Check(int64_t InValue)
     return 0;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+std::vector<std::pair<int64_t, int64_t>> Parse(const std::string& InFileName)
+{
+    Aoc::FMappedFile inputFile(InFileName);
+    std::vector<int64_t> values;
+    Aoc::AppendIntegers(inputFile.GetContents(), values);
+
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    ranges.reserve(values.size() / 2);
+    for (size_t index = 0; index + 1 < values.size(); index += 2)
+        ranges.emplace_back(values[index], values[index + 1]);
+    return ranges;
+}
+
+// Ids that are a block of InBlockSize digits repeated to InLength digits are the block times
+// (10^InLength - 1) / (10^InBlockSize - 1), so the ones inside a range are an arithmetic series over the
+// block value. Returns their sum for ids in [InStart, InEnd]. Sums wrap like the scanning solvers would.
+uint64_t SumBlockRepeats(uint64_t InStart, uint64_t InEnd, int32_t InLength, int32_t InBlockSize)
+{
+    uint64_t lengthPower = 1;
+    for (int32_t digit = 0; digit < InLength; ++digit)
+        lengthPower *= 10;
+    uint64_t blockPower = 1;
+    for (int32_t digit = 0; digit < InBlockSize; ++digit)
+        blockPower *= 10;
+
+    const uint64_t multiplier = (lengthPower - 1) / (blockPower - 1);
+    const uint64_t firstBlock = std::max(blockPower / 10, (InStart + multiplier - 1) / multiplier);
+    const uint64_t lastBlock = std::min(blockPower - 1, InEnd / multiplier);
+    if (firstBlock > lastBlock)
+        return 0;
+
+    const uint64_t count = lastBlock - firstBlock + 1;
+    const uint64_t blockSum = count % 2 == 0 ? count / 2 * (firstBlock + lastBlock)
+        : (firstBlock + lastBlock) / 2 * count;
+    return blockSum * multiplier;
+}
+
+// Calls InSumForLength(start, end, length) once per digit length that [InStart, InEnd] touches
+template <typename TSumForLength>
+int64_t SumPerDigitLength(int64_t InStart, int64_t InEnd, TSumForLength&& InSumForLength)
+{
+    uint64_t sum = 0;
+    uint64_t lengthStart = 1;
+    for (int32_t length = 1; length <= 19; ++length)
+    {
+        const uint64_t lengthEnd = length == 19 ? UINT64_MAX : lengthStart * 10 - 1;
+        const uint64_t start = std::max<uint64_t>(lengthStart, std::max<int64_t>(InStart, 1));
+        const uint64_t end = std::min<uint64_t>(lengthEnd, InEnd < 0 ? 0 : InEnd);
+        if (start <= end)
+            sum += InSumForLength(start, end, length);
+        lengthStart *= 10;
+    }
+    return static_cast<int64_t>(sum);
+}
+
+int32_t Mobius(int32_t InValue)
+{
+    int32_t result = 1;
+    for (int32_t factor = 2; factor * factor <= InValue; ++factor)
+    {
+        if (InValue % factor != 0)
+            continue;
+        InValue /= factor;
+        if (InValue % factor == 0)
+            return 0;
+        result = -result;
+    }
+    return InValue > 1 ? -result : result;
+}
+
+// Ids made of two copies of the same half
+int64_t SumDoubledIds(int64_t InStart, int64_t InEnd)
+{
+    return SumPerDigitLength(InStart, InEnd, [](uint64_t InLengthStart, uint64_t InLengthEnd, int32_t InLength)
+    {
+        return InLength % 2 == 0 ? SumBlockRepeats(InLengthStart, InLengthEnd, InLength, InLength / 2) : 0;
+    });
+}
+
+// Ids made of any block repeated at least twice. An id with smallest period d is counted by every block
+// size that d divides, so the block sizes are combined with inclusion-exclusion: the sum over every proper
+// divisor b of the length of -mobius(length / b) * S(b) counts each of those ids exactly once.
+int64_t SumRepeatedIds(int64_t InStart, int64_t InEnd)
+{
+    return SumPerDigitLength(InStart, InEnd, [](uint64_t InLengthStart, uint64_t InLengthEnd, int32_t InLength)
+    {
+        uint64_t sum = 0;
+        for (int32_t blockSize = 1; blockSize < InLength; ++blockSize)
+        {
+            if (InLength % blockSize != 0)
+                continue;
+            const int32_t sign = -Mobius(InLength / blockSize);
+            if (sign != 0)
+                sum += static_cast<uint64_t>(sign) * SumBlockRepeats(InLengthStart, InLengthEnd, InLength, blockSize);
+        }
+        return sum;
+    });
+}
+
+int64_t SolvePart1(const std::vector<std::pair<int64_t, int64_t>>& InRanges)
 {
-    std::ifstream inputFile;
-    inputFile.open(Filename);
     int64_t part1SumInvalidIds = 0;
+    for (const auto& [startRange, endRange] : InRanges)
+        part1SumInvalidIds += SumDoubledIds(startRange, endRange);
+    return part1SumInvalidIds;
+}
+
+int64_t SolvePart2(const std::vector<std::pair<int64_t, int64_t>>& InRanges)
+{
     int64_t part2SumInvalidIds = 0;
-    while (inputFile.is_open() && !inputFile.eof())
+    for (const auto& [startRange, endRange] : InRanges)
+        part2SumInvalidIds += SumRepeatedIds(startRange, endRange);
+    return part2SumInvalidIds;
+}
+
+// Checks every id in every range, cost grows with the width of the ranges
+int64_t SolvePart1Scan(const std::vector<std::pair<int64_t, int64_t>>& InRanges)
+{
+    int64_t part1SumInvalidIds = 0;
+    for (const auto& [startRange, endRange] : InRanges)
     {
-        int64_t startRange, endRange;
-        inputFile >> startRange;
-        inputFile.ignore(1, '-');
-        inputFile >> endRange;
-        inputFile.ignore(1, ',');
         for (int64_t currentValue = startRange; currentValue <= endRange; currentValue++)
-        {
             part1SumInvalidIds += Part1Check(currentValue);
+    }
+    return part1SumInvalidIds;
+}
+
+int64_t SolvePart2Scan(const std::vector<std::pair<int64_t, int64_t>>& InRanges)
+{
+    int64_t part2SumInvalidIds = 0;
+    for (const auto& [startRange, endRange] : InRanges)
+    {
+        for (int64_t currentValue = startRange; currentValue <= endRange; currentValue++)
             part2SumInvalidIds += Part2Check(currentValue);
-        }
     }
-    std::printf("Result part 1: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part1SumInvalidIds, ANSI_RESET);
-    
-    std::printf("Result part 2: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part2SumInvalidIds, ANSI_RESET);
-    return 0;
+    return part2SumInvalidIds;
+}
+
+static const Aoc::TDayRegistrar Registrar(2, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day02/TestInput.txt", 1227775554, 4174379265},
+    {"Day02/Input.txt", std::nullopt, std::nullopt},
+});
+static const Aoc::TVariantRegistrar ScanPart1(2, 1, "scan", &SolvePart1Scan);
+static const Aoc::TVariantRegistrar ScanPart2(2, 2, "scan", &SolvePart2Scan);
+
 }
@@ -1,51 +1,173 @@
+#include <algorithm>
 #include <array>
-#include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "Simd.h"
 
-//std::string Filename = "TestInput.txt";
-std::string Filename = "Input.txt";
+#if AOC_HAS_SSE2
+#include <emmintrin.h>
+#endif
 
-template <int T>
-int64_t SearchBank(const std::string& InBank)
+namespace Day03
 {
-    std::array<char, T> resultDigits{};
-    for (size_t bankIndex = 0; bankIndex < InBank.size(); bankIndex++)
+
+// int64_t holds 18 digits
+constexpr int32_t MaxDigitCount = 18;
+
+// Largest InDigitCount digit number that keeps the bank's order. Monotonic stack: a digit pops smaller
+// digits off the stack as long as enough digits are left to fill it again, O(n) for any digit count.
+// Banks shorter than InDigitCount score 0.
+int64_t SearchBank(std::string_view InBank, int32_t InDigitCount)
+{
+    if (InDigitCount <= 0 || InDigitCount > MaxDigitCount || InBank.size() < static_cast<size_t>(InDigitCount))
+        return 0;
+
+    std::array<char, MaxDigitCount> stack;
+    int32_t stackSize = 0;
+    size_t allowedDrops = InBank.size() - InDigitCount;
+    for (char digit : InBank)
     {
-        for (size_t resultIndex = 0; resultIndex < resultDigits.size(); resultIndex++)
+        while (allowedDrops > 0 && stackSize > 0 && stack[stackSize - 1] < digit)
         {
-            size_t requiredRemainingDigets = resultDigits.size() - resultIndex;
-            if (requiredRemainingDigets <= InBank.size() - bankIndex && InBank[bankIndex] > resultDigits[resultIndex])
-            {
-                resultDigits[resultIndex] = InBank[bankIndex];
-                for (size_t resetResultIndex = resultIndex + 1; resetResultIndex < resultDigits.size(); resetResultIndex++)
-                    resultDigits[resetResultIndex] = 0;
-                break;
-            }
+            --stackSize;
+            --allowedDrops;
         }
+        if (stackSize < InDigitCount)
+            stack[stackSize++] = digit;
+        else
+            --allowedDrops;
     }
-    return std::atoll(resultDigits.data());
+
+    int64_t value = 0;
+    for (int32_t index = 0; index < InDigitCount; ++index)
+        value = value * 10 + (stack[index] - '0');
+    return value;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+#if AOC_HAS_SSE2
+constexpr size_t BatchSize = 16;
+
+// Scores BatchSize banks of the same length at once, one bank per byte lane. For every bank position the
+// digit improves the first result slot it beats among the slots that can still be filled, and clears the
+// slots after it. The slots that can be filled only depend on the position, so every lane runs the same
+// instructions and only the improved slot differs. That is still O(n * K) work per bank for K digits, the
+// batch only interleaves 16 banks; the O(n) monotonic stack is the "stack" variant.
+void SearchBankBatch(const std::string_view* InBanks, int32_t InDigitCount, int64_t* OutValues)
 {
-    std::ifstream inputFile;
-    inputFile.open(Filename);
-    std::string inputLine;
-    int64_t part1Sum = 0;
-    int64_t part2Sum = 0;
-    while (inputFile.is_open() && !inputFile.eof())
+    const int32_t bankLength = static_cast<int32_t>(InBanks[0].size());
+    if (InDigitCount <= 0 || InDigitCount > MaxDigitCount || bankLength < InDigitCount)
+    {
+        std::fill(OutValues, OutValues + BatchSize, 0);
+        return;
+    }
+
+    __m128i resultDigits[MaxDigitCount];
+    std::fill(resultDigits, resultDigits + MaxDigitCount, _mm_setzero_si128());
+    alignas(16) char column[BatchSize];
+    for (int32_t position = 0; position < bankLength; ++position)
+    {
+        for (size_t lane = 0; lane < BatchSize; ++lane)
+            column[lane] = InBanks[lane][position];
+        const __m128i digit = _mm_load_si128(reinterpret_cast<const __m128i*>(column));
+
+        // Digits are ASCII so the signed byte compare is fine
+        __m128i isPlaced = _mm_setzero_si128();
+        for (int32_t slot = std::max(0, InDigitCount - (bankLength - position)); slot < InDigitCount; ++slot)
+        {
+            const __m128i improves = _mm_andnot_si128(isPlaced, _mm_cmpgt_epi8(digit, resultDigits[slot]));
+            const __m128i kept = _mm_andnot_si128(_mm_or_si128(isPlaced, improves), resultDigits[slot]);
+            resultDigits[slot] = _mm_or_si128(kept, _mm_and_si128(improves, digit));
+            isPlaced = _mm_or_si128(isPlaced, improves);
+        }
+    }
+
+    std::array<std::array<char, BatchSize>, MaxDigitCount> digits;
+    for (int32_t slot = 0; slot < InDigitCount; ++slot)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(digits[slot].data()), resultDigits[slot]);
+    for (size_t lane = 0; lane < BatchSize; ++lane)
+    {
+        int64_t value = 0;
+        for (int32_t slot = 0; slot < InDigitCount; ++slot)
+            value = value * 10 + (digits[slot][lane] - '0');
+        OutValues[lane] = value;
+    }
+}
+#endif
+
+// Sums the scores of all banks, runs of BatchSize consecutive banks with the same length go through the
+// SIMD batch, everything else through SearchBank
+int64_t SearchBanks(const std::vector<std::string_view>& InBanks, int32_t InDigitCount)
+{
+    int64_t sum = 0;
+    size_t bankIndex = 0;
+#if AOC_HAS_SSE2
+    std::array<int64_t, BatchSize> values;
+    while (bankIndex + BatchSize <= InBanks.size())
     {
-        std::getline(inputFile, inputLine);
-        part1Sum += SearchBank<2>(inputLine);
-        part2Sum += SearchBank<12>(inputLine);
+        const size_t bankLength = InBanks[bankIndex].size();
+        size_t sameLength = 1;
+        while (sameLength < BatchSize && InBanks[bankIndex + sameLength].size() == bankLength)
+            ++sameLength;
+        if (sameLength < BatchSize)
+        {
+            for (size_t index = 0; index < sameLength; ++index)
+                sum += SearchBank(InBanks[bankIndex + index], InDigitCount);
+            bankIndex += sameLength;
+            continue;
+        }
+        SearchBankBatch(InBanks.data() + bankIndex, InDigitCount, values.data());
+        for (int64_t value : values)
+            sum += value;
+        bankIndex += BatchSize;
     }
-    std::printf("Result part 1, ends at 0: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part1Sum, ANSI_RESET);
-    std::printf("Result part 2, Number of times past 0: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part2Sum, ANSI_RESET);
-    return 0;
+#endif
+    for (; bankIndex < InBanks.size(); ++bankIndex)
+        sum += SearchBank(InBanks[bankIndex], InDigitCount);
+    return sum;
+}
+
+Aoc::FInputLines Parse(const std::string& InFileName)
+{
+    return Aoc::ReadLines(InFileName);
+}
+
+int64_t SolvePart1(const Aoc::FInputLines& InBanks)
+{
+    return SearchBanks(InBanks.Lines, 2);
+}
+
+int64_t SolvePart2(const Aoc::FInputLines& InBanks)
+{
+    return SearchBanks(InBanks.Lines, 12);
+}
+
+// One bank at a time through the monotonic stack
+int64_t SolvePart1Stack(const Aoc::FInputLines& InBanks)
+{
+    int64_t part1Sum = 0;
+    for (std::string_view bank : InBanks.Lines)
+        part1Sum += SearchBank(bank, 2);
+    return part1Sum;
+}
+
+int64_t SolvePart2Stack(const Aoc::FInputLines& InBanks)
+{
+    int64_t part2Sum = 0;
+    for (std::string_view bank : InBanks.Lines)
+        part2Sum += SearchBank(bank, 12);
+    return part2Sum;
+}
+
+static const Aoc::TDayRegistrar Registrar(3, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day03/TestInput.txt", 357, 3121910778619},
+    {"Day03/Input.txt", std::nullopt, std::nullopt},
+});
+static const Aoc::TVariantRegistrar StackPart1(3, 1, "stack", &SolvePart1Stack);
+static const Aoc::TVariantRegistrar StackPart2(3, 2, "stack", &SolvePart2Stack);
+
 }
@@ -1,19 +1,224 @@
-#include <fstream>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "Parallel.h"
+#include "Simd.h"
 
-//std::string Filename = "TestInput.txt";
-std::string Filename = "Input.txt";
+#if AOC_HAS_SSE2
+#include <emmintrin.h>
+#endif
 
-int32_t WrapTo99(int InCount) {
-    return (InCount % 100 + 100) % 100;
+namespace Day04
+{
+
+// One bit per cell, set for a roll. Rows are padded to whole words and an empty row is kept above and
+// below the board, so neighbour lookups never need bounds checks. Bits past the width stay clear.
+// BackWords is the second buffer removal rounds write the next board into.
+struct FBitBoard
+{
+    int32_t Width = 0;
+    int32_t Height = 0;
+    int32_t WordsPerRow = 0;
+    std::vector<uint64_t> Words;
+    std::vector<uint64_t> BackWords;
+
+    uint64_t* GetRow(int32_t InY) { return Words.data() + static_cast<size_t>(InY + 1) * WordsPerRow; }
+    const uint64_t* GetRow(int32_t InY) const { return Words.data() + static_cast<size_t>(InY + 1) * WordsPerRow; }
+};
+
+FBitBoard MakeBitBoard(const Aoc::FGridView& InGrid)
+{
+    FBitBoard board;
+    board.Width = InGrid.GetWidth();
+    board.Height = InGrid.GetHeight();
+    board.WordsPerRow = (board.Width + 63) / 64;
+    board.Words.assign(static_cast<size_t>(board.Height + 2) * board.WordsPerRow, 0);
+    for (int32_t y = 0; y < board.Height; ++y)
+    {
+        const std::string_view row = InGrid.GetRow(y);
+        uint64_t* words = board.GetRow(y);
+        size_t x = 0;
+#if AOC_HAS_SSE2
+        const __m128i roll = _mm_set1_epi8('@');
+        for (; x + 64 <= row.size(); x += 64)
+        {
+            uint64_t word = 0;
+            for (int32_t block = 0; block < 4; ++block)
+            {
+                const __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.data() + x + block * 16));
+                word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(cells, roll))))
+                    << (block * 16);
+            }
+            words[x / 64] = word;
+        }
+#endif
+        for (; x < row.size(); ++x)
+        {
+            if (row[x] == '@')
+                words[x / 64] |= uint64_t(1) << (x % 64);
+        }
+    }
+    return board;
+}
+
+// Bit x holds the cell at x - 1 / x + 1 of InRow
+uint64_t ShiftedFromWest(const uint64_t* InRow, int32_t InWord)
+{
+    return (InRow[InWord] << 1) | (InWord > 0 ? InRow[InWord - 1] >> 63 : 0);
+}
+
+uint64_t ShiftedFromEast(const uint64_t* InRow, int32_t InWord, int32_t InWordsPerRow)
+{
+    return (InRow[InWord] >> 1) | (InWord + 1 < InWordsPerRow ? InRow[InWord + 1] << 63 : 0);
+}
+
+// Rolls in word InWord of row InY with fewer than 4 of their 8 neighbours set. The neighbours are summed
+// bit-sliced: full adders fold each row triple into sum/carry bits, which leaves the count as
+// ones + 2 * (four weight-two bits). The count reaches 4 exactly when two of the weight-two bits are set.
+uint64_t GetFreeRolls(const FBitBoard& InBoard, int32_t InY, int32_t InWord)
+{
+    const int32_t wordsPerRow = InBoard.WordsPerRow;
+    const uint64_t* above = InBoard.GetRow(InY - 1);
+    const uint64_t* row = InBoard.GetRow(InY);
+    const uint64_t* below = InBoard.GetRow(InY + 1);
+
+    const uint64_t aboveWest = ShiftedFromWest(above, InWord);
+    const uint64_t aboveEast = ShiftedFromEast(above, InWord, wordsPerRow);
+    const uint64_t aboveSum = aboveWest ^ above[InWord] ^ aboveEast;
+    const uint64_t aboveCarry = (aboveWest & above[InWord]) | (aboveEast & (aboveWest ^ above[InWord]));
+
+    const uint64_t belowWest = ShiftedFromWest(below, InWord);
+    const uint64_t belowEast = ShiftedFromEast(below, InWord, wordsPerRow);
+    const uint64_t belowSum = belowWest ^ below[InWord] ^ belowEast;
+    const uint64_t belowCarry = (belowWest & below[InWord]) | (belowEast & (belowWest ^ below[InWord]));
+
+    const uint64_t west = ShiftedFromWest(row, InWord);
+    const uint64_t east = ShiftedFromEast(row, InWord, wordsPerRow);
+    const uint64_t rowSum = west ^ east;
+    const uint64_t rowCarry = west & east;
+
+    const uint64_t onesCarry = (aboveSum & belowSum) | (rowSum & (aboveSum ^ belowSum));
+    const uint64_t atLeastFour = (aboveCarry & belowCarry) | (rowCarry & onesCarry)
+        | ((aboveCarry ^ belowCarry) & (rowCarry ^ onesCarry));
+    return row[InWord] & ~atLeastFour;
+}
+
+// Counts the rolls with fewer than 4 neighbours, 64 cells at a time. The board is split into bands of rows
+// that run on the worker threads. A band reads the row above and below it (its halo rows) straight from the
+// shared board, which is safe because nothing writes to that board during the pass: with
+// InbShouldRemoveFound the bands write the board without the found rolls into BackWords and the buffers are
+// swapped once every band is done. Removal is therefore round-synchronous, every roll of a round sees the
+// board as it was when the round started. The counts per round differ from removing while scanning, the
+// total over all rounds does not.
+int64_t CountFreeRolls(const bool InbShouldRemoveFound, FBitBoard& InOutBoard)
+{
+    constexpr size_t minWordsPerBand = 1 << 14;
+    const size_t minRowsPerBand = std::max<size_t>(1, minWordsPerBand / std::max(1, InOutBoard.WordsPerRow));
+    const size_t bandCount = Aoc::GetBlockCount(InOutBoard.Height, minRowsPerBand);
+    if (InbShouldRemoveFound)
+        InOutBoard.BackWords.resize(InOutBoard.Words.size(), 0);
+
+    std::vector<int64_t> bandCounts(bandCount, 0);
+    Aoc::ParallelForBlocks(InOutBoard.Height, bandCount, [&](size_t InBand, size_t InBegin, size_t InEnd)
+    {
+        int64_t countFound = 0;
+        for (int32_t y = static_cast<int32_t>(InBegin); y < static_cast<int32_t>(InEnd); ++y)
+        {
+            const uint64_t* row = InOutBoard.GetRow(y);
+            uint64_t* nextRow = InOutBoard.BackWords.data() + static_cast<size_t>(y + 1) * InOutBoard.WordsPerRow;
+            for (int32_t word = 0; word < InOutBoard.WordsPerRow; ++word)
+            {
+                const uint64_t found = GetFreeRolls(InOutBoard, y, word);
+                countFound += std::popcount(found);
+                if (InbShouldRemoveFound)
+                    nextRow[word] = row[word] & ~found;
+            }
+        }
+        bandCounts[InBand] = countFound;
+    });
+
+    if (InbShouldRemoveFound)
+        InOutBoard.Words.swap(InOutBoard.BackWords);
+    int64_t countFound = 0;
+    for (int64_t bandCount : bandCounts)
+        countFound += bandCount;
+    return countFound;
 }
 
-int CountFreeRolls(const bool InbShouldRemoveFound, std::vector<std::vector<char>>& InOutBoard)
+struct FPeelResult
+{
+    int64_t Removed = 0;
+    int32_t Rounds = 0;
+};
+
+// Removes free rolls until none are left while only ever looking at the neighbours of removed rolls.
+// Every roll keeps its neighbour count, a removal decrements the counts around it and queues the rolls
+// that drop below 4 for the next round. Rounds are round-synchronous, like CountFreeRolls with removal.
+FPeelResult PeelRolls(const Aoc::FGridView& InGrid)
+{
+    // Padded by one cell on every side so the neighbours of a real cell are always in range
+    const int64_t stride = InGrid.GetWidth() + 2;
+    const int64_t height = InGrid.GetHeight() + 2;
+    std::vector<uint8_t> isRoll(static_cast<size_t>(stride * height), 0);
+    for (int32_t y = 0; y < InGrid.GetHeight(); ++y)
+    {
+        const std::string_view row = InGrid.GetRow(y);
+        uint8_t* cells = isRoll.data() + (y + 1) * stride + 1;
+        for (size_t x = 0; x < row.size(); ++x)
+            cells[x] = row[x] == '@';
+    }
+
+    const int64_t neighbourOffsets[8] = { -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1 };
+    std::vector<uint8_t> neighbourCounts(isRoll.size(), 0);
+    std::vector<int64_t> currentRound;
+    for (int64_t index = stride; index < stride * (height - 1); ++index)
+    {
+        if (!isRoll[index])
+            continue;
+        uint8_t count = 0;
+        for (int64_t offset : neighbourOffsets)
+            count += isRoll[index + offset];
+        neighbourCounts[index] = count;
+        if (count < 4)
+            currentRound.push_back(index);
+    }
+
+    // A queued roll is cleared from isRoll right away so it is neither counted down nor queued again
+    for (int64_t index : currentRound)
+        isRoll[index] = 0;
+
+    FPeelResult result;
+    std::vector<int64_t> nextRound;
+    while (!currentRound.empty())
+    {
+        result.Removed += static_cast<int64_t>(currentRound.size());
+        result.Rounds++;
+        for (int64_t index : currentRound)
+        {
+            for (int64_t offset : neighbourOffsets)
+            {
+                const int64_t neighbour = index + offset;
+                if (isRoll[neighbour] && --neighbourCounts[neighbour] < 4)
+                {
+                    isRoll[neighbour] = 0;
+                    nextRound.push_back(neighbour);
+                }
+            }
+        }
+        currentRound.swap(nextRound);
+        nextRound.clear();
+    }
+    return result;
+}
+
+// Cell by cell version that removes rolls while it scans
+int CountFreeRollsInGrid(const bool InbShouldRemoveFound, std::vector<std::vector<char>>& InOutBoard)
 {
     int boundX = static_cast<int>(InOutBoard[0].size());
     int boundY = static_cast<int>(InOutBoard.size());
@@ -48,32 +253,77 @@ int CountFreeRolls(const bool InbShouldRemoveFound, std::vector<std::vector<char
     return countFound;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+// Mutable copy of the mapped board for CountFreeRollsInGrid
+std::vector<std::vector<char>> MakeBoard(const Aoc::FGridView& InGrid)
 {
-    std::ifstream inputFile;
-    inputFile.open(Filename);
-    std::string inputLine;
     std::vector<std::vector<char>> board;
+    board.reserve(InGrid.GetHeight());
+    for (std::string_view row : InGrid.GetRows())
+        board.emplace_back(row.begin(), row.end());
+    return board;
+}
 
-    while (inputFile.is_open() && !inputFile.eof())
-    {
-        std::getline(inputFile, inputLine);
-        board.emplace_back(inputLine.begin(), inputLine.end());
-    }
-    
-    int64_t part1Count = CountFreeRolls(false, board);
-    
+Aoc::FInputGrid Parse(const std::string& InFileName)
+{
+    return Aoc::ReadGrid(InFileName);
+}
+
+int64_t SolvePart1(const Aoc::FInputGrid& InBoard)
+{
+    FBitBoard board = MakeBitBoard(InBoard.Grid);
+    return CountFreeRolls(false, board);
+}
+
+// A roll that becomes free stays free, so the total does not depend on the order rolls are removed in
+int64_t SolvePart2(const Aoc::FInputGrid& InBoard)
+{
+    const FPeelResult result = PeelRolls(InBoard.Grid);
+    Aoc::SetCounter("rounds", result.Rounds);
+    return result.Removed;
+}
+
+// Full word-parallel passes over the board until a round removes nothing
+int64_t SolvePart2BitBoard(const Aoc::FInputGrid& InBoard)
+{
+    FBitBoard board = MakeBitBoard(InBoard.Grid);
     int64_t part2Count = 0;
     int64_t lastReturned;
+    int32_t rounds = 0;
     do
     {
         lastReturned = CountFreeRolls(true, board);
         part2Count += lastReturned;
+        rounds += lastReturned > 0;
     } while (lastReturned > 0);
-    
-    std::printf("Result part 1: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET);
-    return 0;
+    Aoc::SetCounter("rounds", rounds);
+    return part2Count;
+}
+
+int64_t SolvePart1Grid(const Aoc::FInputGrid& InBoard)
+{
+    std::vector<std::vector<char>> board = MakeBoard(InBoard.Grid);
+    return CountFreeRollsInGrid(false, board);
+}
+
+int64_t SolvePart2Grid(const Aoc::FInputGrid& InBoard)
+{
+    std::vector<std::vector<char>> board = MakeBoard(InBoard.Grid);
+    int64_t part2Count = 0;
+    int64_t lastReturned;
+    do
+    {
+        lastReturned = CountFreeRollsInGrid(true, board);
+        part2Count += lastReturned;
+    } while (lastReturned > 0);
+    return part2Count;
+}
+
+static const Aoc::TDayRegistrar Registrar(4, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day04/TestInput.txt", 13, 43},
+    {"Day04/Input.txt", std::nullopt, std::nullopt},
+});
+static const Aoc::TVariantRegistrar BitBoardPart2(4, 2, "bitboard", &SolvePart2BitBoard);
+static const Aoc::TVariantRegistrar GridPart1(4, 1, "grid", &SolvePart1Grid);
+static const Aoc::TVariantRegistrar GridPart2(4, 2, "grid", &SolvePart2Grid);
+
 }
@@ -1,65 +1,283 @@
 #include <algorithm>
+#include <bit>
 #include <chrono>
-#include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
+#include "IntervalSet.h"
+#include "Parallel.h"
 
-void Day07(const std::string& InFileName)
+namespace Day05
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    
-    int64_t part1Count = 0;
-    int64_t part2Count = 0;
-    
-    std::vector<std::pair<int64_t, int64_t>> nonSpoiledRanges;
-    
 
-    bool readingRanged = true;
-    while (inputFile.is_open() && !inputFile.eof())
+// Disjoint ranges built from possibly overlapping inclusive ranges: sorted once, merged in one pass and
+// stored in Eytzinger order (the implicit binary tree layout, node k has children 2k and 2k + 1), so the
+// first levels of every search share cache lines and the search loop has no unpredictable branch.
+class FIntervalIndex
+{
+public:
+    FIntervalIndex() = default;
+    explicit FIntervalIndex(std::vector<std::pair<int64_t, int64_t>> InRanges)
     {
-        std::getline(inputFile, inputLine);
-        if (readingRanged && inputLine.size() == 0)
+        std::sort(InRanges.begin(), InRanges.end());
+        std::vector<std::pair<int64_t, int64_t>> merged;
+        for (const auto& [start, end] : InRanges)
         {
-            readingRanged = false;
-            continue;
+            // Touching ranges merge as well, ids are never negative so start - 1 cannot overflow
+            if (!merged.empty() && start - 1 <= merged.back().second)
+                merged.back().second = std::max(merged.back().second, end);
+            else
+                merged.emplace_back(start, end);
         }
-        if (readingRanged)
+
+        for (const auto& [start, end] : merged)
+            CoveredCount += end - start + 1;
+
+        // Slot 0 is unused so the root is node 1
+        Nodes.resize(merged.size() + 1);
+        size_t sortedIndex = 0;
+        FillEytzinger(merged, sortedIndex, 1);
+        SortedRanges = std::move(merged);
+    }
+
+    bool Contains(int64_t InValue) const
+    {
+        // Walk down to the first range that ends at or after InValue, the trailing ones of k count the
+        // right turns taken after it
+        const size_t nodeCount = Nodes.size() - 1;
+        size_t k = 1;
+        while (k <= nodeCount)
+            k = 2 * k + (Nodes[k].End < InValue);
+        k >>= std::countr_one(k) + 1;
+        return k != 0 && Nodes[k].Start <= InValue;
+    }
+
+    // Number of InSortedValues that fall inside a range, in one merge pass over values and ranges
+    int64_t CountContainedSorted(const int64_t* InSortedValues, size_t InCount) const
+    {
+        if (InCount == 0)
+            return 0;
+        auto range = std::lower_bound(SortedRanges.begin(), SortedRanges.end(), InSortedValues[0],
+            [](const std::pair<int64_t, int64_t>& InRange, int64_t InValue) { return InRange.second < InValue; });
+        int64_t count = 0;
+        for (size_t index = 0; index < InCount && range != SortedRanges.end(); ++index)
         {
-            int64_t start, end;
-            sscanf_s(inputLine.c_str(), "%lld-%lld", &start, &end, inputLine.size());
-            if (start < end)
-                nonSpoiledRanges.emplace_back(start, end);
-            else
-                nonSpoiledRanges.emplace_back(end, start);
+            const int64_t value = InSortedValues[index];
+            while (range != SortedRanges.end() && range->second < value)
+                ++range;
+            count += range != SortedRanges.end() && range->first <= value;
+        }
+        return count;
+    }
+
+    int64_t GetRangeCount() const { return static_cast<int64_t>(Nodes.size()) - 1; }
+    int64_t GetCoveredCount() const { return CoveredCount; }
+
+private:
+    struct FNode
+    {
+        int64_t End = 0;
+        int64_t Start = 0;
+    };
+
+    void FillEytzinger(const std::vector<std::pair<int64_t, int64_t>>& InSorted, size_t& InOutSortedIndex,
+        size_t InNode)
+    {
+        if (InNode >= Nodes.size())
+            return;
+        FillEytzinger(InSorted, InOutSortedIndex, 2 * InNode);
+        Nodes[InNode].Start = InSorted[InOutSortedIndex].first;
+        Nodes[InNode].End = InSorted[InOutSortedIndex].second;
+        ++InOutSortedIndex;
+        FillEytzinger(InSorted, InOutSortedIndex, 2 * InNode + 1);
+    }
+
+    std::vector<FNode> Nodes = std::vector<FNode>(1);
+    std::vector<std::pair<int64_t, int64_t>> SortedRanges;
+    int64_t CoveredCount = 0;
+};
+
+// LSD radix sort on 11 bit digits of the distance to the smallest value, passes above the highest set bit
+// are skipped
+void RadixSort(int64_t* InOutValues, size_t InCount, std::vector<int64_t>& InOutScratch)
+{
+    if (InCount < 2)
+        return;
+    const auto [minValue, maxValue] = std::minmax_element(InOutValues, InOutValues + InCount);
+    const int64_t base = *minValue;
+    const uint64_t span = static_cast<uint64_t>(*maxValue) - static_cast<uint64_t>(base);
+
+    constexpr int32_t digitBits = 11;
+    constexpr size_t bucketCount = size_t(1) << digitBits;
+    InOutScratch.resize(InCount);
+    int64_t* source = InOutValues;
+    int64_t* target = InOutScratch.data();
+    std::vector<size_t> offsets(bucketCount + 1);
+    for (int32_t shift = 0; shift < 64 && (span >> shift) != 0; shift += digitBits)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (size_t index = 0; index < InCount; ++index)
+            offsets[((static_cast<uint64_t>(source[index]) - base) >> shift & (bucketCount - 1)) + 1]++;
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+            offsets[bucket + 1] += offsets[bucket];
+        for (size_t index = 0; index < InCount; ++index)
+            target[offsets[(static_cast<uint64_t>(source[index]) - base) >> shift & (bucketCount - 1)]++] = source[index];
+        std::swap(source, target);
+    }
+    if (source != InOutValues)
+        std::copy(source, source + InCount, InOutValues);
+}
+
+struct FIngredientDatabase
+{
+    std::vector<std::pair<int64_t, int64_t>> NonSpoiledRanges;
+    std::vector<int64_t> IngredientIds;
+    FIntervalIndex FreshIndex;
+};
+
+FIngredientDatabase Parse(const std::string& InFileName)
+{
+    Aoc::FMappedFile inputFile(InFileName);
+    const std::string_view contents = inputFile.GetContents();
+    Aoc::FLineReader lineReader(contents);
+    std::string_view inputLine;
+    FIngredientDatabase database;
+
+    // Ranges and ids are separated by the first empty line
+    std::string_view rangesText = contents;
+    std::string_view idsText;
+    while (lineReader.Next(inputLine))
+    {
+        if (inputLine.size() == 0)
+        {
+            const size_t separator = inputLine.data() - contents.data();
+            rangesText = contents.substr(0, separator);
+            idsText = contents.substr(separator);
+            break;
         }
+    }
+
+    std::vector<int64_t> rangeValues;
+    Aoc::AppendIntegers(rangesText, rangeValues);
+    database.NonSpoiledRanges.reserve(rangeValues.size() / 2);
+    for (size_t index = 0; index + 1 < rangeValues.size(); index += 2)
+    {
+        int64_t start = rangeValues[index];
+        int64_t end = rangeValues[index + 1];
+        if (start < end)
+            database.NonSpoiledRanges.emplace_back(start, end);
         else
+            database.NonSpoiledRanges.emplace_back(end, start);
+    }
+    Aoc::AppendIntegers(idsText, database.IngredientIds);
+    database.FreshIndex = FIntervalIndex(database.NonSpoiledRanges);
+    return database;
+}
+
+void SetQueriesPerSecondCounter(size_t InQueryCount, std::chrono::steady_clock::time_point InStart)
+{
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - InStart).count();
+    Aoc::SetCounter("queries/s", seconds > 0 ? static_cast<int64_t>(InQueryCount / seconds) : 0);
+}
+
+// One index lookup per id
+int64_t SolvePart1(const FIngredientDatabase& InDatabase)
+{
+    const auto start = std::chrono::steady_clock::now();
+    int64_t part1Count = 0;
+    for (int64_t checkSpoled : InDatabase.IngredientIds)
+        part1Count += InDatabase.FreshIndex.Contains(checkSpoled);
+    SetQueriesPerSecondCounter(InDatabase.IngredientIds.size(), start);
+    return part1Count;
+}
+
+// Every worker radix sorts its own block of ids and sweeps it against the merged ranges, the counts of the
+// blocks are summed. Worth it once there are far more ids than fit in cache.
+int64_t SolvePart1Bulk(const FIngredientDatabase& InDatabase)
+{
+    const auto start = std::chrono::steady_clock::now();
+    constexpr size_t minBlockSize = 1 << 15;
+    const std::vector<int64_t>& ids = InDatabase.IngredientIds;
+    std::vector<int64_t> sortedIds = ids;
+    const size_t blockCount = Aoc::GetBlockCount(ids.size(), minBlockSize);
+    std::vector<int64_t> blockCounts(blockCount, 0);
+    Aoc::ParallelForBlocks(ids.size(), blockCount, [&](size_t InBlock, size_t InBegin, size_t InEnd)
+    {
+        std::vector<int64_t> scratch;
+        RadixSort(sortedIds.data() + InBegin, InEnd - InBegin, scratch);
+        blockCounts[InBlock] = InDatabase.FreshIndex.CountContainedSorted(sortedIds.data() + InBegin,
+            InEnd - InBegin);
+    });
+
+    int64_t part1Count = 0;
+    for (int64_t blockCount : blockCounts)
+        part1Count += blockCount;
+    SetQueriesPerSecondCounter(ids.size(), start);
+    return part1Count;
+}
+
+int64_t SolvePart2(const FIngredientDatabase& InDatabase)
+{
+    return InDatabase.FreshIndex.GetCoveredCount();
+}
+
+// Feeds the ranges one by one into the dynamic set, the way the production feed updates it
+Aoc::FDynamicIntervalSet MakeDynamicSet(const FIngredientDatabase& InDatabase)
+{
+    Aoc::FDynamicIntervalSet freshRanges;
+    for (const auto& [start, end] : InDatabase.NonSpoiledRanges)
+        freshRanges.Insert(start, end);
+    return freshRanges;
+}
+
+int64_t SolvePart1Dynamic(const FIngredientDatabase& InDatabase)
+{
+    const Aoc::FDynamicIntervalSet freshRanges = MakeDynamicSet(InDatabase);
+    int64_t part1Count = 0;
+    for (int64_t checkSpoled : InDatabase.IngredientIds)
+        part1Count += freshRanges.Contains(checkSpoled);
+    return part1Count;
+}
+
+int64_t SolvePart2Dynamic(const FIngredientDatabase& InDatabase)
+{
+    return MakeDynamicSet(InDatabase).GetCoveredCount();
+}
+
+// Checks every id against every range
+int64_t SolvePart1Scan(const FIngredientDatabase& InDatabase)
+{
+    int64_t part1Count = 0;
+    for (int64_t checkSpoled : InDatabase.IngredientIds)
+    {
+        bool isSpoiled = true;
+        for (const auto& range : InDatabase.NonSpoiledRanges)
         {
-            int64_t checkSpoled;
-            sscanf_s(inputLine.c_str(), "%lld", &checkSpoled, inputLine.size());
-            bool isSpoiled = true;
-            for (const auto& range : nonSpoiledRanges)
+            if (checkSpoled >= range.first && checkSpoled <= range.second)
             {
-                if (checkSpoled >= range.first && checkSpoled <= range.second)
-                {
-                    isSpoiled = false;
-                    break;
-                }
-            }
-            if (!isSpoiled)
-            {
-                part1Count++;
+                isSpoiled = false;
+                break;
             }
         }
+        if (!isSpoiled)
+        {
+            part1Count++;
+        }
     }
-    
-    auto start = std::chrono::high_resolution_clock::now();
+    return part1Count;
+}
+
+// Merges the ranges by repeatedly erasing the ones that overlap
+int64_t SolvePart2Scan(const FIngredientDatabase& InDatabase)
+{
+    int64_t part2Count = 0;
+    std::vector<std::pair<int64_t, int64_t>> nonSpoiledRanges = InDatabase.NonSpoiledRanges;
     std::sort(nonSpoiledRanges.begin(), nonSpoiledRanges.end(), 
         [](const std::pair<int64_t, int64_t>& InLHS, const std::pair<int64_t, int64_t>& InRHS)
     {
@@ -89,17 +307,17 @@ void Day07(const std::string& InFileName)
     {
        part2Count += nonSpoiledRange.second - nonSpoiledRange.first + 1;
     }
-    auto end = std::chrono::high_resolution_clock::now();
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
-    std::printf("Result part 1: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET);
+    return part2Count;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
-{
-    Day07("TestInput.txt");
-    Day07("Input.txt");
-    return 0;
+static const Aoc::TDayRegistrar Registrar(5, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day05/TestInput.txt", 3, 14},
+    {"Day05/Input.txt", std::nullopt, std::nullopt},
+});
+static const Aoc::TVariantRegistrar BulkPart1(5, 1, "bulk", &SolvePart1Bulk);
+static const Aoc::TVariantRegistrar DynamicPart1(5, 1, "dynamic", &SolvePart1Dynamic);
+static const Aoc::TVariantRegistrar DynamicPart2(5, 2, "dynamic", &SolvePart2Dynamic);
+static const Aoc::TVariantRegistrar ScanPart1(5, 1, "scan", &SolvePart1Scan);
+static const Aoc::TVariantRegistrar ScanPart2(5, 2, "scan", &SolvePart2Scan);
+
 }
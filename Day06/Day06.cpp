@@ -1,13 +1,54 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
+#include <bit>
 #include <iostream>
-#include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+#if AOC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Day06
+{
+
+// A run of columns of the number rows stored column by column, Rows bytes per column. Cells has 16 bytes of padding
+// at the end so a column can always be read with whole SSE2 loads. Ops holds the op row (the last line),
+// BlankColumns has a bit set for every column that is a space in every row including the op row.
+struct FColumnSheet
+{
+    static constexpr int32_t Padding = 16;
+
+    int32_t Rows = 0;
+    int64_t Width = 0;
+    std::vector<char> Cells;
+    std::vector<char> Ops;
+    std::vector<uint64_t> BlankColumns;
+
+    const char* GetColumn(int64_t InX) const { return Cells.data() + InX * Rows; }
+    bool IsBlank(int64_t InX) const { return (BlankColumns[InX / 64] >> (InX % 64)) & 1; }
+};
+
+struct FWorksheet
+{
+    Aoc::FMappedFile File;
+    std::vector<std::string_view> AllLines;
+};
+
+// Shared by both parts: a product starts from the first number instead of from 1
+void ApplyOp(char InOp, int64_t InNumber, int64_t& InOutResult)
+{
+    if (InOp == '+')
+        InOutResult += InNumber;
+    else
+        InOutResult = InOutResult != 0 ? InOutResult * InNumber : InNumber;
+}
 
 int64_t CalculatePart1(const std::vector<std::vector<int64_t>>& InNumbers, const std::vector<char>& InOps)
 {
@@ -32,13 +73,13 @@ int64_t CalculatePart1(const std::vector<std::vector<int64_t>>& InNumbers, const
     return part1Count;
 }
 
-int64_t CalculatePart2(const std::vector<std::string>& InAllLines)
+int64_t CalculatePart2(const std::vector<std::string_view>& InAllLines)
 {
     int64_t part2Count = 0;
     int maxRowLength = 0;
     for (auto& line : InAllLines)
     {
-        maxRowLength = std::max<std::basic_string<char>::size_type>(line.size(), maxRowLength);
+        maxRowLength = std::max<std::string_view::size_type>(line.size(), maxRowLength);
     }
     char lastOp;
     int64_t currentResult = 0;
@@ -51,7 +92,7 @@ int64_t CalculatePart2(const std::vector<std::string>& InAllLines)
         
         bool allEmpty = std::all_of(InAllLines.begin(), InAllLines.end(), [i](const auto& InLine)
         {
-            return InLine[i] == ' ';
+            return i >= InLine.size() || InLine[i] == ' ';
         });
         
         if (!allEmpty)
@@ -63,7 +104,7 @@ int64_t CalculatePart2(const std::vector<std::string>& InAllLines)
                 if (isOpLine)
                     break;
                 
-                if (line.size() < i)
+                if (line.size() <= i)
                     continue;
                 
                 if (line[i] != ' ')
@@ -95,71 +136,271 @@ int64_t CalculatePart2(const std::vector<std::string>& InAllLines)
     return part2Count;
 }
 
-void Day07(const std::string& InFileName)
+bool IsBlankColumn(const std::vector<std::string_view>& InAllLines, int64_t InX)
+{
+    return std::all_of(InAllLines.begin(), InAllLines.end(), [InX](std::string_view InLine)
+    {
+        return InX >= static_cast<int64_t>(InLine.size()) || InLine[InX] == ' ';
+    });
+}
+
+// Fills OutSheet with the columns [InBegin, InEnd) of the lines, the buffers of OutSheet are reused so a
+// worker can go through many chunks with a single allocation
+void MakeColumnSheet(const std::vector<std::string_view>& InAllLines, int64_t InBegin, int64_t InEnd,
+    FColumnSheet& OutSheet)
+{
+    OutSheet.Rows = static_cast<int32_t>(InAllLines.size()) - 1;
+    OutSheet.Width = InEnd - InBegin;
+    OutSheet.Cells.assign(static_cast<size_t>(OutSheet.Width) * OutSheet.Rows + FColumnSheet::Padding, ' ');
+    for (int32_t y = 0; y < OutSheet.Rows; ++y)
+    {
+        const std::string_view line = InAllLines[y];
+        const int64_t end = std::min<int64_t>(InEnd, static_cast<int64_t>(line.size()));
+        for (int64_t x = InBegin; x < end; ++x)
+            OutSheet.Cells[(x - InBegin) * OutSheet.Rows + y] = line[x];
+    }
+    const std::string_view opLine = InAllLines.back();
+    OutSheet.Ops.assign(static_cast<size_t>(OutSheet.Width), ' ');
+    for (int64_t x = InBegin; x < std::min<int64_t>(InEnd, static_cast<int64_t>(opLine.size())); ++x)
+        OutSheet.Ops[x - InBegin] = opLine[x];
+
+    OutSheet.BlankColumns.assign(static_cast<size_t>((OutSheet.Width + 63) / 64), 0);
+    for (int64_t x = 0; x < OutSheet.Width; ++x)
+    {
+        const char* column = OutSheet.GetColumn(x);
+        const bool isBlank = OutSheet.Ops[x] == ' '
+            && std::all_of(column, column + OutSheet.Rows, [](char InCell) { return InCell == ' '; });
+        OutSheet.BlankColumns[x / 64] |= static_cast<uint64_t>(isBlank) << (x % 64);
+    }
+}
+
+// Reads a column top to bottom as one number, every non-space cell is a digit. The non-space cells are found
+// 16 rows at a time and only those are folded into the number.
+int64_t ReadVerticalNumber(const FColumnSheet& InSheet, int64_t InX)
+{
+    const char* column = InSheet.GetColumn(InX);
+    int64_t number = 0;
+#if AOC_HAS_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    for (int32_t row = 0; row < InSheet.Rows; row += 16)
+    {
+        const __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + row));
+        const uint32_t rowMask = InSheet.Rows - row >= 16 ? 0xFFFF : (1u << (InSheet.Rows - row)) - 1;
+        uint32_t digits = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(cells, space))) & rowMask;
+        while (digits != 0)
+        {
+            number = number * 10 + (column[row + std::countr_zero(digits)] - '0');
+            digits &= digits - 1;
+        }
+    }
+#else
+    for (int32_t row = 0; row < InSheet.Rows; ++row)
+    {
+        if (column[row] != ' ')
+            number = number * 10 + (column[row] - '0');
+    }
+#endif
+    return number;
+}
+
+// Same result as CalculatePart1 in one pass over the problem blocks: the number of a row is the digits of that
+// row inside the block, the op is the one under the block
+int64_t CalculatePart1Columns(const FColumnSheet& InSheet)
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    
     int64_t part1Count = 0;
+    std::vector<int64_t> rowNumbers(InSheet.Rows, 0);
+    std::vector<uint8_t> rowHasDigits(InSheet.Rows, 0);
+    char op = ' ';
+    for (int64_t x = 0; x <= InSheet.Width; ++x)
+    {
+        if (x < InSheet.Width && !InSheet.IsBlank(x))
+        {
+            op = op == ' ' ? InSheet.Ops[x] : op;
+            // Branch free, spaces sit at unpredictable places
+            const char* column = InSheet.GetColumn(x);
+            for (int32_t y = 0; y < InSheet.Rows; ++y)
+            {
+                const int32_t digit = column[y] - '0';
+                const bool isDigit = static_cast<uint32_t>(digit) < 10;
+                rowNumbers[y] = isDigit ? rowNumbers[y] * 10 + digit : rowNumbers[y];
+                rowHasDigits[y] |= isDigit;
+            }
+            continue;
+        }
+
+        int64_t result = 0;
+        for (int32_t y = 0; y < InSheet.Rows; ++y)
+        {
+            if (rowHasDigits[y])
+                ApplyOp(op, rowNumbers[y], result);
+            rowNumbers[y] = 0;
+            rowHasDigits[y] = 0;
+        }
+        part1Count += result;
+        op = ' ';
+    }
+    return part1Count;
+}
+
+// Same result as CalculatePart2 in one pass over the columns. InLastOp is the op in effect at the first
+// column, the last op before the chunk when the sheet is evaluated in chunks.
+int64_t CalculatePart2Columns(const FColumnSheet& InSheet, char InLastOp)
+{
     int64_t part2Count = 0;
-    
+    int64_t currentResult = 0;
+    char lastOp = InLastOp;
+    for (int64_t x = 0; x < InSheet.Width; ++x)
+    {
+        if (InSheet.Ops[x] != ' ')
+            lastOp = InSheet.Ops[x];
+
+        const bool isBlank = InSheet.IsBlank(x);
+        if (!isBlank)
+        {
+            const int64_t number = ReadVerticalNumber(InSheet, x);
+            if (number != 0)
+                ApplyOp(lastOp, number, currentResult);
+        }
+        if (isBlank || x == InSheet.Width - 1)
+        {
+            part2Count += currentResult;
+            currentResult = 0;
+        }
+    }
+    return part2Count;
+}
+
+// Splits the sheet into chunks of about InChunkWidth columns that each end at a blank column (or the end of
+// the sheet), so no problem is cut in two and every chunk can be evaluated on its own
+std::vector<int64_t> SplitIntoChunks(const std::vector<std::string_view>& InAllLines, int64_t InChunkWidth)
+{
+    int64_t width = 0;
+    for (std::string_view line : InAllLines)
+        width = std::max<int64_t>(width, static_cast<int64_t>(line.size()));
+
+    std::vector<int64_t> chunkBegins = {0};
+    while (chunkBegins.back() < width)
+    {
+        int64_t end = std::min(width, chunkBegins.back() + InChunkWidth);
+        while (end < width && !IsBlankColumn(InAllLines, end))
+            ++end;
+        chunkBegins.push_back(end);
+    }
+    return chunkBegins;
+}
+
+// The op in effect at column InX for part 2, which is the last op to the left of it
+char FindOpBefore(std::string_view InOpLine, int64_t InX)
+{
+    for (int64_t x = std::min<int64_t>(InX, static_cast<int64_t>(InOpLine.size())) - 1; x >= 0; --x)
+    {
+        if (InOpLine[x] != ' ')
+            return InOpLine[x];
+    }
+    return '*';
+}
+
+// Evaluates the sheet chunk by chunk straight from the mapped lines. Every worker transposes one chunk at a
+// time into its own FColumnSheet, so the memory in use is bounded by the chunk size and the worker count
+// instead of by the width of the sheet.
+int64_t CalculateInChunks(const std::vector<std::string_view>& InAllLines, int32_t InPart)
+{
+    if (InAllLines.size() < 2)
+        return 0;
+
+    constexpr int64_t chunkBytes = 1 << 20;
+    const int64_t rows = static_cast<int64_t>(InAllLines.size()) - 1;
+    const std::vector<int64_t> chunkBegins = SplitIntoChunks(InAllLines, std::max<int64_t>(64, chunkBytes / rows));
+    const size_t chunkCount = chunkBegins.size() - 1;
+    const size_t blockCount = Aoc::GetBlockCount(chunkCount, 1);
+    std::vector<int64_t> blockTotals(blockCount, 0);
+    Aoc::ParallelForBlocks(chunkCount, blockCount, [&](size_t InBlock, size_t InBegin, size_t InEnd)
+    {
+        FColumnSheet sheet;
+        for (size_t chunk = InBegin; chunk < InEnd; ++chunk)
+        {
+            MakeColumnSheet(InAllLines, chunkBegins[chunk], chunkBegins[chunk + 1], sheet);
+            blockTotals[InBlock] += InPart == 1 ? CalculatePart1Columns(sheet)
+                : CalculatePart2Columns(sheet, FindOpBefore(InAllLines.back(), chunkBegins[chunk]));
+        }
+    });
+
+    int64_t total = 0;
+    for (int64_t blockTotal : blockTotals)
+        total += blockTotal;
+    return total;
+}
+
+// Row-major numbers and ops for CalculatePart1
+void ReadRows(const std::vector<std::string_view>& InAllLines, std::vector<std::vector<int64_t>>& OutNumbers,
+    std::vector<char>& OutOps)
+{
     bool readOps = false;
-    std::vector<std::vector<int64_t>> numbers;
-    std::vector<std::string> allLines;
-    std::vector<char> ops;
-    while (inputFile.is_open() && !inputFile.eof())
+    for (std::string_view inputLine : InAllLines)
     {
-        std::getline(inputFile, inputLine);
-        allLines.emplace_back(inputLine);
-        std::regex e(R"(\d+|[\\*\\+])");
-        
-        std::sregex_iterator iter(inputLine.begin(), inputLine.end(), e);
-        std::sregex_iterator end;
-        
-        if (iter == end)
+        const size_t firstToken = inputLine.find_first_not_of(' ');
+        if (firstToken == std::string_view::npos)
             continue;
-        
-        if ((*iter)[0] == '+' || (*iter)[0] == '*')
+
+        if (inputLine[firstToken] == '+' || inputLine[firstToken] == '*')
             readOps = true;
-        
-        std::vector<int64_t> currentNumberLine;
-        
-        while(iter != end)
+
+        if (readOps)
         {
-            for(unsigned i = 0; i < iter->size(); ++i)
+            for (char op : inputLine)
             {
-                if (readOps)
-                    ops.emplace_back((*iter)[0].str()[0]);
-                else
-                {
-                    currentNumberLine.emplace_back(atoll((*iter)[0].str().c_str()));
-                }
+                if (op == '+' || op == '*')
+                    OutOps.emplace_back(op);
             }
-            ++iter;
+            continue;
         }
+
+        std::vector<int64_t> currentNumberLine;
+        Aoc::AppendIntegers(inputLine, currentNumberLine);
         if (!currentNumberLine.empty())
         {
-            numbers.emplace_back(std::move(currentNumberLine));
+            OutNumbers.emplace_back(std::move(currentNumberLine));
         }
     }
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    part1Count = CalculatePart1(numbers, ops);
-    part2Count = CalculatePart2(allLines);
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
-}
-
-int main(int /*InArgc*/, char* /*InArgv[]*/)
-{
-    Day07("TestInput.txt");
-    Day07("Input.txt");
-    return 0;
+}
+
+FWorksheet Parse(const std::string& InFileName)
+{
+    FWorksheet worksheet;
+    worksheet.File = Aoc::FMappedFile(InFileName);
+    worksheet.AllLines = Aoc::SplitLines(worksheet.File.GetContents());
+    return worksheet;
+}
+
+int64_t SolvePart1(const FWorksheet& InWorksheet)
+{
+    return CalculateInChunks(InWorksheet.AllLines, 1);
+}
+
+int64_t SolvePart2(const FWorksheet& InWorksheet)
+{
+    return CalculateInChunks(InWorksheet.AllLines, 2);
+}
+
+// The original row by row evaluation straight from the lines
+int64_t SolvePart1Rows(const FWorksheet& InWorksheet)
+{
+    std::vector<std::vector<int64_t>> numbers;
+    std::vector<char> ops;
+    ReadRows(InWorksheet.AllLines, numbers, ops);
+    return CalculatePart1(numbers, ops);
+}
+
+int64_t SolvePart2Rows(const FWorksheet& InWorksheet)
+{
+    return CalculatePart2(InWorksheet.AllLines);
+}
+
+static const Aoc::TDayRegistrar Registrar(6, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day06/TestInput.txt", 4277556, 3263827},
+    {"Day06/Input.txt", std::nullopt, std::nullopt},
+});
+static const Aoc::TVariantRegistrar RowsPart1(6, 1, "rows", &SolvePart1Rows);
+static const Aoc::TVariantRegistrar RowsPart2(6, 2, "rows", &SolvePart2Rows);
+
 }
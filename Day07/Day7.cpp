@@ -1,13 +1,23 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
+#include <bit>
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "Simd.h"
+
+#if AOC_HAS_AVX2
+#include <immintrin.h>
+#elif AOC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Day07
+{
 
 template <typename T>
 bool IsValidIndex(const T& InContainer, int InIndex)
@@ -58,7 +68,7 @@ int64_t ProcessPart1(std::vector<std::string> processLines)
     return part1Count;
 }
 
-int64_t ProcessPart2(std::vector<std::string>& InVectorm, int x, int y, std::map<std::pair<int, int>, int64_t>& OutCachedLines)
+int64_t ProcessPart2(const std::vector<std::string_view>& InVectorm, int x, int y, std::map<std::pair<int, int>, int64_t>& OutCachedLines)
 {
     if (const bool isLastLine = y == InVectorm.size() - 1)
         return 1;
@@ -83,39 +93,285 @@ int64_t ProcessPart2(std::vector<std::string>& InVectorm, int x, int y, std::map
     return result;
 }
 
-void Day12(const std::string& InFileName, const int64_t InPart1Expected, const int64_t InPart2Expected)
+struct FManifoldResult
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    
-    
-    std::vector<std::string> processLines;
-    while (inputFile.is_open() && !inputFile.eof())
+    int64_t Splits = 0;
+    int64_t Timelines = 0;
+};
+
+// One top-down sweep over the rows as they are read, only the beams and the timeline counts of the current
+// row are kept. The beams follow ProcessPart1: a split marks the '.' cells next to the splitter and counts
+// when it marked at least one of them. The timeline counts follow ProcessPart2: they start at the S column
+// on the second row and every splitter sends its count to both neighbours.
+FManifoldResult SweepManifold(std::string_view InContents)
+{
+    FManifoldResult result;
+    Aoc::FLineReader lineReader(InContents);
+    std::string_view line;
+    if (!lineReader.Next(line))
+        return result;
+
+    std::vector<uint8_t> beams(line.size(), 0);
+    for (size_t x = 0; x < line.size(); ++x)
+        beams[x] = line[x] == 'S' || line[x] == '|';
+    const size_t start = line.find('S');
+    std::vector<int64_t> timelines;
+    std::vector<uint8_t> nextBeams;
+    std::vector<int64_t> nextTimelines;
+
+    for (int32_t y = 1; lineReader.Next(line); ++y)
     {
-        std::getline(inputFile, inputLine);
-        processLines.emplace_back(std::move(inputLine));
+        const size_t width = std::max(beams.size(), line.size());
+        nextBeams.assign(width, 0);
+        nextTimelines.assign(width, 0);
+        for (size_t x = 0; x < beams.size(); ++x)
+        {
+            if (!beams[x])
+                continue;
+            if (x < line.size() && line[x] == '^')
+            {
+                bool wasSplit = false;
+                if (x >= 1 && line[x - 1] == '.' && !nextBeams[x - 1])
+                {
+                    nextBeams[x - 1] = 1;
+                    wasSplit = true;
+                }
+                if (x + 1 < line.size() && line[x + 1] == '.' && !nextBeams[x + 1])
+                {
+                    nextBeams[x + 1] = 1;
+                    wasSplit = true;
+                }
+                result.Splits += wasSplit;
+            }
+            else if (x < line.size())
+                nextBeams[x] = 1;
+        }
+        for (size_t x = 0; x < line.size(); ++x)
+            nextBeams[x] |= line[x] == 'S' || line[x] == '|';
+
+        if (y == 1)
+        {
+            if (start != std::string_view::npos && start < width)
+                nextTimelines[start] = 1;
+        }
+        else
+        {
+            for (size_t x = 0; x < timelines.size(); ++x)
+            {
+                const int64_t count = timelines[x];
+                if (count == 0)
+                    continue;
+                if (x < line.size() && line[x] == '^')
+                {
+                    if (x >= 1)
+                        nextTimelines[x - 1] += count;
+                    if (x + 1 < width)
+                        nextTimelines[x + 1] += count;
+                }
+                else
+                    nextTimelines[x] += count;
+            }
+        }
+        std::swap(beams, nextBeams);
+        std::swap(timelines, nextTimelines);
     }
-    
-    std::vector<std::string> processLinesPart2 = processLines;
-    auto start = std::chrono::high_resolution_clock::now();
-    int64_t part1Count = ProcessPart1(processLines);
-    auto foundItr = std::find(processLines[0].begin(), processLines[0].end(), 'S');
-    std::map<std::pair<int, int>, int64_t> cachedLines;
-    int64_t part2Count = ProcessPart2(processLinesPart2, foundItr - processLines[0].begin() , 1, cachedLines);
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part1Count == InPart1Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part2Count == InPart2Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
+
+    for (int64_t count : timelines)
+        result.Timelines += count;
+    return result;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+// The cells of one row as bit masks, bit x of word x / 64 is column x. Every mask has a zero word in front
+// of word 0 and zero words after the last one, so the kernels can read the neighbouring words of any word
+// and the AVX2 kernel can work on whole groups of four words.
+struct FBeamRow
 {
-    Day12("TestInput.txt", 21,40);
-    Day12("Input.txt", 1594, 15650261281478);
-    return 0;
+    static constexpr size_t WordGroup = 4;
+
+    size_t Words = 0;
+    std::vector<uint64_t> Splitters;
+    std::vector<uint64_t> Empty;       // '.'
+    std::vector<uint64_t> Valid;       // inside the line
+    std::vector<uint64_t> Sources;     // 'S' and '|'
+
+    void Resize(size_t InWidth)
+    {
+        Words = std::max(Words, (InWidth + 63) / 64);
+        const size_t storedWords = (Words + WordGroup - 1) / WordGroup * WordGroup + 2;
+        for (std::vector<uint64_t>* mask : {&Splitters, &Empty, &Valid, &Sources})
+            mask->assign(storedWords, 0);
+    }
+};
+
+// Bits 0..InCount-1 of the result are set when the matching byte equals InChar
+uint64_t MatchBytes(const char* InBytes, size_t InCount, char InChar)
+{
+    uint64_t mask = 0;
+    size_t x = 0;
+#if AOC_HAS_SSE2
+    const __m128i match = _mm_set1_epi8(InChar);
+    for (; x + 16 <= InCount; x += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InBytes + x));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, match)))) << x;
+    }
+#endif
+    for (; x < InCount; ++x)
+        mask |= static_cast<uint64_t>(InBytes[x] == InChar) << x;
+    return mask;
+}
+
+void MakeBeamRow(std::string_view InLine, FBeamRow& OutRow)
+{
+    OutRow.Resize(InLine.size());
+    for (size_t word = 0; word * 64 < InLine.size(); ++word)
+    {
+        const char* bytes = InLine.data() + word * 64;
+        const size_t count = std::min<size_t>(64, InLine.size() - word * 64);
+        OutRow.Splitters[word + 1] = MatchBytes(bytes, count, '^');
+        OutRow.Empty[word + 1] = MatchBytes(bytes, count, '.');
+        OutRow.Valid[word + 1] = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+        OutRow.Sources[word + 1] = MatchBytes(bytes, count, 'S') | MatchBytes(bytes, count, '|');
+    }
+}
+
+// Moves the beams InBeams one row down onto InRow and returns the number of splits, with the same rules as
+// ProcessPart1. With H the beams that hit a splitter, a split counts when the cell right of it is empty, or
+// the cell left of it is empty and did not already get a beam from straight above (a beam left of the
+// splitter) or from the splitter two to the left.
+int64_t StepBeams(const uint64_t* InBeams, const FBeamRow& InRow, uint64_t* OutBeams)
+{
+    const uint64_t* splitters = InRow.Splitters.data() + 1;
+    const uint64_t* empty = InRow.Empty.data() + 1;
+    const uint64_t* valid = InRow.Valid.data() + 1;
+    const uint64_t* sources = InRow.Sources.data() + 1;
+    int64_t splits = 0;
+    size_t word = 0;
+#if AOC_HAS_AVX2
+    const auto load = [](const uint64_t* InData) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(InData)); };
+    const auto fromWest = [](__m256i InWords, __m256i InPrevious, int InShift)
+    {
+        return _mm256_or_si256(_mm256_slli_epi64(InWords, InShift), _mm256_srli_epi64(InPrevious, 64 - InShift));
+    };
+    // Popcount of every byte through a nibble table, summed per 64 bit lane
+    const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    __m256i splitCounts = _mm256_setzero_si256();
+    for (; word < InRow.Words; word += FBeamRow::WordGroup)
+    {
+        const __m256i beams = load(InBeams + word);
+        const __m256i beamsWest = load(InBeams + word - 1);
+        const __m256i split = _mm256_and_si256(beams, load(splitters + word));
+        const __m256i splitWest = _mm256_and_si256(beamsWest, load(splitters + word - 1));
+        const __m256i splitEast = _mm256_and_si256(load(InBeams + word + 1), load(splitters + word + 1));
+        const __m256i emptyCells = load(empty + word);
+        const __m256i emptyEast = _mm256_or_si256(_mm256_srli_epi64(emptyCells, 1),
+            _mm256_slli_epi64(load(empty + word + 1), 63));
+        const __m256i emptyWest = fromWest(emptyCells, load(empty + word - 1), 1);
+        const __m256i leftTaken = _mm256_or_si256(fromWest(beams, beamsWest, 1), fromWest(split, splitWest, 2));
+        const __m256i counted = _mm256_and_si256(split, _mm256_or_si256(emptyEast, _mm256_andnot_si256(leftTaken, emptyWest)));
+        const __m256i lowCounts = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(counted, lowNibble));
+        const __m256i highCounts = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi16(counted, 4), lowNibble));
+        splitCounts = _mm256_add_epi64(splitCounts,
+            _mm256_sad_epu8(_mm256_add_epi8(lowCounts, highCounts), _mm256_setzero_si256()));
+
+        const __m256i splitSides = _mm256_or_si256(fromWest(split, splitWest, 1),
+            _mm256_or_si256(_mm256_srli_epi64(split, 1), _mm256_slli_epi64(splitEast, 63)));
+        const __m256i straight = _mm256_andnot_si256(load(splitters + word), _mm256_and_si256(beams, load(valid + word)));
+        const __m256i next = _mm256_or_si256(_mm256_or_si256(straight, _mm256_and_si256(splitSides, emptyCells)),
+            load(sources + word));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(OutBeams + word), next);
+    }
+    alignas(32) int64_t laneCounts[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(laneCounts), splitCounts);
+    splits += laneCounts[0] + laneCounts[1] + laneCounts[2] + laneCounts[3];
+#endif
+    for (; word < InRow.Words; ++word)
+    {
+        const uint64_t beams = InBeams[word];
+        const uint64_t split = beams & splitters[word];
+        const uint64_t splitWest = InBeams[word - 1] & splitters[word - 1];
+        const uint64_t splitEast = InBeams[word + 1] & splitters[word + 1];
+        const uint64_t emptyEast = (empty[word] >> 1) | (empty[word + 1] << 63);
+        const uint64_t emptyWest = (empty[word] << 1) | (empty[word - 1] >> 63);
+        const uint64_t leftTaken = (beams << 1) | (InBeams[word - 1] >> 63) | (split << 2) | (splitWest >> 62);
+        splits += std::popcount(split & (emptyEast | (emptyWest & ~leftTaken)));
+
+        const uint64_t splitSides = (split << 1) | (splitWest >> 63) | (split >> 1) | (splitEast << 63);
+        OutBeams[word] = (beams & valid[word] & ~splitters[word]) | (splitSides & empty[word]) | sources[word];
+    }
+    return splits;
+}
+
+// Same result as ProcessPart1 with the beams of a row kept as a bitset, every step handles 64 columns per
+// word (256 with AVX2)
+int64_t CountSplitsBitset(std::string_view InContents)
+{
+    Aoc::FLineReader lineReader(InContents);
+    std::string_view line;
+    if (!lineReader.Next(line))
+        return 0;
+
+    FBeamRow row;
+    MakeBeamRow(line, row);
+    std::vector<uint64_t> beams = row.Sources;
+    std::vector<uint64_t> nextBeams;
+    int64_t splits = 0;
+    while (lineReader.Next(line))
+    {
+        MakeBeamRow(line, row);
+        beams.resize(row.Splitters.size(), 0);
+        nextBeams.assign(row.Splitters.size(), 0);
+        splits += StepBeams(beams.data() + 1, row, nextBeams.data() + 1);
+        std::swap(beams, nextBeams);
+    }
+    return splits;
+}
+
+Aoc::FMappedFile Parse(const std::string& InFileName)
+{
+    return Aoc::FMappedFile(InFileName);
+}
+
+int64_t SolvePart1(const Aoc::FMappedFile& InFile)
+{
+    return SweepManifold(InFile.GetContents()).Splits;
+}
+
+int64_t SolvePart2(const Aoc::FMappedFile& InFile)
+{
+    return SweepManifold(InFile.GetContents()).Timelines;
+}
+
+int64_t SolvePart1Bitset(const Aoc::FMappedFile& InFile)
+{
+    return CountSplitsBitset(InFile.GetContents());
+}
+
+// The original grid walk and memoised recursion
+int64_t SolvePart1Recursive(const Aoc::FMappedFile& InFile)
+{
+    const std::vector<std::string_view> lines = Aoc::SplitLines(InFile.GetContents());
+    // ProcessPart1 draws the beams into the grid, so it works on its own copy
+    return ProcessPart1(std::vector<std::string>(lines.begin(), lines.end()));
+}
+
+int64_t SolvePart2Recursive(const Aoc::FMappedFile& InFile)
+{
+    const std::vector<std::string_view> lines = Aoc::SplitLines(InFile.GetContents());
+    const std::string_view firstLine = lines[0];
+    auto foundItr = std::find(firstLine.begin(), firstLine.end(), 'S');
+    std::map<std::pair<int, int>, int64_t> cachedLines;
+    return ProcessPart2(lines, static_cast<int>(foundItr - firstLine.begin()), 1, cachedLines);
+}
+
+static const Aoc::TDayRegistrar Registrar(7, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day07/TestInput.txt", 21, 40},
+    {"Day07/Input.txt", 1594, 15650261281478},
+});
+static const Aoc::TVariantRegistrar BitsetPart1(7, 1, "bitset", &SolvePart1Bitset);
+static const Aoc::TVariantRegistrar RecursivePart1(7, 1, "recursive", &SolvePart1Recursive);
+static const Aoc::TVariantRegistrar RecursivePart2(7, 2, "recursive", &SolvePart2Recursive);
+
 }
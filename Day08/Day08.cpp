@@ -1,132 +1,500 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <functional>
 #include <iostream>
-#include <map>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
-#include <ranges>
-#include <unordered_map>
-#include <numeric>
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+#if AOC_HAS_AVX2
+#include <immintrin.h>
+#endif
 
-class FVector
+namespace Day08
 {
-public:
-    FVector() = default;
-    FVector(double InX, double InY, double InZ)
-        : X(InX), Y(InY), Z(InZ) {}
 
-    double Distance2 (const FVector& InOther) const
+// The junction boxes with one array per axis, so the distance kernels read every axis with contiguous loads.
+// Coordinates stay below CoordinateLimit = 2^30 in magnitude, Parse rejects anything else. That keeps every
+// difference inside the signed 32 bit multiply of the AVX2 kernel and every squared distance exact in an int64.
+struct FPointCloud
+{
+    static constexpr int64_t CoordinateLimit = int64_t(1) << 30;
+
+    std::vector<int32_t> X;
+    std::vector<int32_t> Y;
+    std::vector<int32_t> Z;
+
+    size_t GetCount() const { return X.size(); }
+
+    void Add(int32_t InX, int32_t InY, int32_t InZ)
+    {
+        X.push_back(InX);
+        Y.push_back(InY);
+        Z.push_back(InZ);
+    }
+};
+
+// OutDistances2[k] is the squared distance from (InX, InY, InZ) to point InBegin + k of InCloud, for every
+// point in [InBegin, InEnd). The AVX2 path handles four points per step.
+void ComputeDistances2(const FPointCloud& InCloud, int32_t InX, int32_t InY, int32_t InZ, size_t InBegin,
+    size_t InEnd, int64_t* OutDistances2)
+{
+    size_t index = InBegin;
+#if AOC_HAS_AVX2
+    const __m256i x = _mm256_set1_epi64x(InX);
+    const __m256i y = _mm256_set1_epi64x(InY);
+    const __m256i z = _mm256_set1_epi64x(InZ);
+    const auto difference = [](const int32_t* InCoordinates, __m256i InOrigin)
+    {
+        const __m128i coordinates = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InCoordinates));
+        return _mm256_sub_epi64(_mm256_cvtepi32_epi64(coordinates), InOrigin);
+    };
+    for (; index + 4 <= InEnd; index += 4)
     {
-        return std::pow(InOther.X - X, 2) 
-        + std::pow(InOther.Y - Y, 2)
-        + std::pow(InOther.Z - Z, 2);
+        const __m256i dx = difference(InCloud.X.data() + index, x);
+        const __m256i dy = difference(InCloud.Y.data() + index, y);
+        const __m256i dz = difference(InCloud.Z.data() + index, z);
+        const __m256i distance2 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epi32(dx, dx), _mm256_mul_epi32(dy, dy)),
+            _mm256_mul_epi32(dz, dz));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(OutDistances2 + (index - InBegin)), distance2);
     }
+#endif
+    for (; index < InEnd; ++index)
+    {
+        const int64_t dx = static_cast<int64_t>(InCloud.X[index]) - InX;
+        const int64_t dy = static_cast<int64_t>(InCloud.Y[index]) - InY;
+        const int64_t dz = static_cast<int64_t>(InCloud.Z[index]) - InZ;
+        OutDistances2[index - InBegin] = dx * dx + dy * dy + dz * dz;
+    }
+}
 
-    bool operator==(const FVector& InOtherVector) const
+// Walks the pair triangle for the rows InFirstRow, InFirstRow + InRowStep, ... and every row against all
+// later points, a tile at a time. InVisit(a, tileBegin, distances2, tileCount) gets the squared distances
+// from a to the points [tileBegin, tileBegin + tileCount).
+template <typename TVisit>
+void ForEachPairTile(const FPointCloud& InCloud, size_t InFirstRow, size_t InRowStep, TVisit&& InVisit)
+{
+    constexpr size_t tileSize = 256;
+    int64_t distances2[tileSize];
+    const size_t pointCount = InCloud.GetCount();
+    for (size_t a = InFirstRow; a < pointCount; a += InRowStep)
     {
-        return X == InOtherVector.X && Y == InOtherVector.Y && Z == InOtherVector.Z;
+        for (size_t tileBegin = a + 1; tileBegin < pointCount; tileBegin += tileSize)
+        {
+            const size_t tileEnd = std::min(pointCount, tileBegin + tileSize);
+            ComputeDistances2(InCloud, InCloud.X[a], InCloud.Y[a], InCloud.Z[a], tileBegin, tileEnd, distances2);
+            InVisit(a, tileBegin, distances2, tileEnd - tileBegin);
+        }
     }
-    double X = -1;
-    double Y = -1;
-    double Z = -1;
-    int32_t Circuit = -1;
-};
+}
 
+// Union by size with path halving, so trees stay O(log n) deep and find never recurses
 struct DSU {
     std::vector<int> parent;
+    std::vector<int> size;
 
-    DSU(size_t n) : parent(n) {
+    DSU(size_t n) : parent(n), size(n, 1) {
         std::iota(parent.begin(), parent.end(), 0);
     }
 
     int find(int v) {
-        if (parent[v] == v) return v;
-        return parent[v] = find(parent[v]);
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
     }
 
-    void unite(int a, int b) {
+    // Returns false when a and b were already in the same set
+    bool unite(int a, int b) {
         a = find(a);
         b = find(b);
-        if (a != b) parent[b] = a;
+        if (a == b) return false;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
     }
 };
 
-void Day12(const std::string& InFileName, const int64_t InPart1Expected, const int64_t InPart2Expected)
+// The boxes and how many of the closest pairs part 1 connects, 1000 unless the input says otherwise
+struct FPlayground
+{
+    FPointCloud Boxes;
+    size_t ConnectionCount = 1000;
+};
+
+FPlayground Parse(const std::string& InFileName, const std::optional<int64_t>& InConnectionCount)
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    
-    std::vector<FVector> inputVectors;
-    
-    while (inputFile.is_open() && !inputFile.eof())
-    {
-        FVector newVector;
-        char delimiter;
-        inputFile >> newVector.X >> delimiter >> newVector.Y >> delimiter >> newVector.Z;
-        std::getline(inputFile, inputLine);
-        inputVectors.emplace_back(newVector);
-    }
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    int64_t part1Count = 0;
-    int64_t part2Count = 0;
-
-    auto pairs = inputVectors 
-        | std::views::transform([&](const FVector& a) {
-              return inputVectors
-                  | std::views::filter([&](const FVector& b){ return &a < &b; }) // only keep one ordering
-                  | std::views::transform([&](const FVector& b) {
-                        return std::tuple{a, b, a.Distance2(b)};
-                    });
-          })
-        | std::views::join  // flatten nested ranges
-        | std::views::filter([](const std::tuple<FVector, FVector, double>& InCheck){return std::get<2>(InCheck) != 0;})
-        | std::ranges::to<std::vector<std::tuple<FVector, FVector, double>>>();
-    
-    std::ranges::sort(pairs, [](const std::tuple<FVector, FVector, double>& InVec1, const std::tuple<FVector, FVector, double>& InVec2)
-        { return std::get<2>(InVec1) < std::get<2>(InVec2); });
-    
-    pairs = pairs
-    | std::views::filter([](auto&& tup){ return std::get<2>(tup) != 0; })
-    | std::views::take(10)
-    | std::ranges::to<std::vector<std::tuple<FVector, FVector, double>>>();
-    
-    // pairs is vector<tuple<FVector,FVector,double>>
-    DSU dsu(inputVectors.size());
-
-    // Map FVector* back to index
-    auto indexOf = [&](const FVector& v) {
-        return static_cast<int>(&v - &inputVectors[0]);
+    Aoc::FMappedFile inputFile(InFileName);
+    std::vector<int64_t> coordinates;
+    Aoc::AppendIntegers(inputFile.GetContents(), coordinates);
+
+    FPlayground playground;
+    const auto isOutOfRange = [](int64_t InCoordinate)
+    {
+        return InCoordinate <= -FPointCloud::CoordinateLimit || InCoordinate >= FPointCloud::CoordinateLimit;
     };
+    if (std::any_of(coordinates.begin(), coordinates.end(), isOutOfRange))
+    {
+        std::fprintf(stderr, "Day 08: coordinates have to stay below 2^30 in magnitude\n");
+        return playground;
+    }
+    for (size_t index = 0; index + 2 < coordinates.size(); index += 3)
+    {
+        playground.Boxes.Add(static_cast<int32_t>(coordinates[index]), static_cast<int32_t>(coordinates[index + 1]),
+            static_cast<int32_t>(coordinates[index + 2]));
+    }
+    if (InConnectionCount.has_value())
+        playground.ConnectionCount = static_cast<size_t>(std::max<int64_t>(0, *InConnectionCount));
+    return playground;
+}
+
+// A pair of junction boxes by index, A < B. Equal distances are ordered by index so the K closest pairs are
+// always the same set.
+struct FEdge
+{
+    int64_t Distance2 = 0;
+    int32_t A = 0;
+    int32_t B = 0;
+
+    bool operator<(const FEdge& InOther) const
+    {
+        return std::tie(Distance2, A, B) < std::tie(InOther.Distance2, InOther.A, InOther.B);
+    }
+};
+
+// Keeps the Capacity smallest edges offered to it in a max heap, so the edge to evict is always on top
+class FClosestEdges
+{
+public:
+    explicit FClosestEdges(size_t InCapacity) : Capacity(InCapacity) { Edges.reserve(InCapacity); }
 
-    for (auto& [a,b,d] : pairs) {
-        dsu.unite(indexOf(a), indexOf(b));
+    // Largest distance that can still get in, lets the pair loop skip most pairs without touching the heap
+    int64_t GetThreshold() const
+    {
+        return Edges.size() < Capacity ? std::numeric_limits<int64_t>::max() : Edges.front().Distance2;
     }
 
-    // Group by root
-    std::unordered_map<int, std::vector<FVector>> circuits;
-    for (auto& [a,b,d] : pairs) {
-        circuits[dsu.find(indexOf(a))].push_back(a);
-        circuits[dsu.find(indexOf(b))].push_back(b);
+    void Push(const FEdge& InEdge)
+    {
+        if (Edges.size() < Capacity)
+        {
+            Edges.push_back(InEdge);
+            std::push_heap(Edges.begin(), Edges.end());
+        }
+        else if (Capacity > 0 && InEdge < Edges.front())
+        {
+            std::pop_heap(Edges.begin(), Edges.end());
+            Edges.back() = InEdge;
+            std::push_heap(Edges.begin(), Edges.end());
+        }
     }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part1Count == InPart1Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part2Count == InPart2Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
+
+    const std::vector<FEdge>& GetEdges() const { return Edges; }
+
+private:
+    size_t Capacity = 0;
+    std::vector<FEdge> Edges;
+};
+
+// The InCount closest pairs in increasing distance without storing all n^2 / 2 of them. Every block takes
+// every blockCount-th row of the pair triangle so the long and short rows are spread evenly, and keeps its
+// own bounded heap. The heaps are merged with nth_element at the end, so memory is O(K * blocks).
+// Pairs at distance 0 are skipped like before.
+std::vector<FEdge> SelectClosestEdges(const FPointCloud& InCloud, size_t InCount)
+{
+    const size_t blockCount = Aoc::GetBlockCount(InCloud.GetCount(), 64);
+    std::vector<FClosestEdges> blockEdges(blockCount, FClosestEdges(InCount));
+    Aoc::RunBlocks(blockCount, [&](size_t InBlock)
+    {
+        FClosestEdges& edges = blockEdges[InBlock];
+        ForEachPairTile(InCloud, InBlock, blockCount,
+            [&](size_t InA, size_t InTileBegin, const int64_t* InDistances2, size_t InTileCount)
+        {
+            int64_t threshold = edges.GetThreshold();
+            for (size_t index = 0; index < InTileCount; ++index)
+            {
+                const int64_t distance2 = InDistances2[index];
+                if (distance2 == 0 || distance2 > threshold)
+                    continue;
+                edges.Push({distance2, static_cast<int32_t>(InA), static_cast<int32_t>(InTileBegin + index)});
+                threshold = edges.GetThreshold();
+            }
+        });
+    });
+
+    std::vector<FEdge> closest;
+    for (const FClosestEdges& edges : blockEdges)
+        closest.insert(closest.end(), edges.GetEdges().begin(), edges.GetEdges().end());
+    if (closest.size() > InCount)
+    {
+        std::nth_element(closest.begin(), closest.begin() + InCount, closest.end());
+        closest.resize(InCount);
+    }
+    std::sort(closest.begin(), closest.end());
+    return closest;
+}
+
+int64_t SolvePart1(const FPlayground& InPlayground)
+{
+    const FPointCloud& boxes = InPlayground.Boxes;
+    if (boxes.GetCount() == 0)
+        return 0;
+    DSU dsu(boxes.GetCount());
+    for (const FEdge& edge : SelectClosestEdges(boxes, InPlayground.ConnectionCount))
+        dsu.unite(edge.A, edge.B);
+
+    std::vector<int64_t> circuitSizes;
+    for (int index = 0; index < static_cast<int>(boxes.GetCount()); ++index)
+    {
+        if (dsu.find(index) == index)
+            circuitSizes.push_back(dsu.size[index]);
+    }
+
+    const size_t largestCount = std::min<size_t>(3, circuitSizes.size());
+    std::partial_sort(circuitSizes.begin(), circuitSizes.begin() + largestCount, circuitSizes.end(),
+        std::greater<int64_t>());
+    int64_t part1Count = 1;
+    for (size_t index = 0; index < largestCount; ++index)
+        part1Count *= circuitSizes[index];
+    return part1Count;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+// Uniform grid over the bounding box. Cloud holds the boxes sorted by cell, the boxes of cell c are
+// [CellStarts[c], CellStarts[c + 1]) in Cloud and Points maps them back to their index in the input.
+struct FPointGrid
+{
+    double CellSize = 1;
+    int64_t Dimensions[3] = {1, 1, 1};
+    double Minimum[3] = {0, 0, 0};
+    double Maximum[3] = {0, 0, 0};
+    std::vector<int32_t> CellStarts;
+    FPointCloud Cloud;
+    std::vector<int32_t> Points;
+    std::vector<int64_t> OccupiedCells;
+
+    int64_t GetCell(int64_t InX, int64_t InY, int64_t InZ) const
+    {
+        return (InZ * Dimensions[1] + InY) * Dimensions[0] + InX;
+    }
+};
+
+// Cells are at least InMinCellSize wide and hold about two boxes on average for an evenly spread cloud
+FPointGrid MakePointGrid(const FPointCloud& InCloud, double InMinCellSize)
 {
-    Day12("TestInput.txt", 40, 25272);
-    //Day07("Input.txt", 66640,78894156);
-    return 0;
+    FPointGrid grid;
+    for (int32_t axis = 0; axis < 3; ++axis)
+    {
+        grid.Minimum[axis] = std::numeric_limits<double>::max();
+        grid.Maximum[axis] = std::numeric_limits<double>::lowest();
+    }
+    for (size_t index = 0; index < InCloud.GetCount(); ++index)
+    {
+        const double coordinates[3] = {static_cast<double>(InCloud.X[index]), static_cast<double>(InCloud.Y[index]),
+            static_cast<double>(InCloud.Z[index])};
+        for (int32_t axis = 0; axis < 3; ++axis)
+        {
+            grid.Minimum[axis] = std::min(grid.Minimum[axis], coordinates[axis]);
+            grid.Maximum[axis] = std::max(grid.Maximum[axis], coordinates[axis]);
+        }
+    }
+
+    const double pointCount = static_cast<double>(InCloud.GetCount());
+    double volume = 1;
+    for (int32_t axis = 0; axis < 3; ++axis)
+        volume *= std::max(1.0, grid.Maximum[axis] - grid.Minimum[axis]);
+    grid.CellSize = std::max({1.0, InMinCellSize, std::cbrt(2 * volume / pointCount)});
+    // Flat or stretched clouds can still give far more cells than boxes
+    while (true)
+    {
+        double cellCount = 1;
+        for (int32_t axis = 0; axis < 3; ++axis)
+        {
+            grid.Dimensions[axis] = static_cast<int64_t>((grid.Maximum[axis] - grid.Minimum[axis]) / grid.CellSize) + 1;
+            cellCount *= static_cast<double>(grid.Dimensions[axis]);
+        }
+        if (cellCount <= 8 * pointCount + 64)
+            break;
+        grid.CellSize *= 1.25;
+    }
+
+    std::vector<int64_t> pointCells(InCloud.GetCount());
+    grid.CellStarts.assign(static_cast<size_t>(grid.Dimensions[0] * grid.Dimensions[1] * grid.Dimensions[2]) + 1, 0);
+    for (size_t index = 0; index < InCloud.GetCount(); ++index)
+    {
+        pointCells[index] = grid.GetCell(static_cast<int64_t>((InCloud.X[index] - grid.Minimum[0]) / grid.CellSize),
+            static_cast<int64_t>((InCloud.Y[index] - grid.Minimum[1]) / grid.CellSize),
+            static_cast<int64_t>((InCloud.Z[index] - grid.Minimum[2]) / grid.CellSize));
+        grid.CellStarts[pointCells[index] + 1]++;
+    }
+    for (size_t cell = 0; cell + 1 < grid.CellStarts.size(); ++cell)
+    {
+        if (grid.CellStarts[cell + 1] != 0)
+            grid.OccupiedCells.push_back(static_cast<int64_t>(cell));
+        grid.CellStarts[cell + 1] += grid.CellStarts[cell];
+    }
+    grid.Points.resize(InCloud.GetCount());
+    std::vector<int32_t> fill(grid.CellStarts.begin(), grid.CellStarts.end() - 1);
+    for (size_t index = 0; index < InCloud.GetCount(); ++index)
+        grid.Points[fill[pointCells[index]]++] = static_cast<int32_t>(index);
+    for (int32_t point : grid.Points)
+        grid.Cloud.Add(InCloud.X[point], InCloud.Y[point], InCloud.Z[point]);
+    return grid;
+}
+
+// Every edge between different circuits with InMinDistance2 < distance2 <= InMaxDistance2, sorted. Only the
+// cell offsets whose closest and farthest possible distance overlap that band are visited. A box of the
+// largest circuit never starts a pair, it is only found from the other side, so once most boxes are joined
+// the work follows the boxes that are left rather than the whole cloud.
+std::vector<FEdge> CollectBandEdges(const FPointGrid& InGrid,
+    const std::vector<int32_t>& InCircuits, int32_t InLargestCircuit, int64_t InMinDistance2, int64_t InMaxDistance2)
+{
+    const double cellSize2 = InGrid.CellSize * InGrid.CellSize;
+    const int64_t reach = static_cast<int64_t>(std::sqrt(static_cast<double>(InMaxDistance2)) / InGrid.CellSize) + 1;
+    std::vector<std::array<int64_t, 3>> offsets;
+    for (int64_t dz = -reach; dz <= reach; ++dz)
+    {
+        for (int64_t dy = -reach; dy <= reach; ++dy)
+        {
+            for (int64_t dx = -reach; dx <= reach; ++dx)
+            {
+                double nearest = 0;
+                double farthest = 0;
+                for (int64_t delta : {dx, dy, dz})
+                {
+                    const double cells = static_cast<double>(delta < 0 ? -delta : delta);
+                    nearest += std::max(0.0, cells - 1) * std::max(0.0, cells - 1);
+                    farthest += (cells + 1) * (cells + 1);
+                }
+                if (nearest * cellSize2 <= static_cast<double>(InMaxDistance2)
+                    && farthest * cellSize2 > static_cast<double>(InMinDistance2))
+                    offsets.push_back({dx, dy, dz});
+            }
+        }
+    }
+
+    const size_t cellCount = InGrid.OccupiedCells.size();
+    const size_t blockCount = Aoc::GetBlockCount(cellCount, 256);
+    std::vector<std::vector<FEdge>> blockEdges(blockCount);
+    Aoc::ParallelForBlocks(cellCount, blockCount, [&](size_t InBlock, size_t InBegin, size_t InEnd)
+    {
+        std::vector<FEdge>& edges = blockEdges[InBlock];
+        std::vector<int64_t> distances2;
+        for (size_t occupied = InBegin; occupied < InEnd; ++occupied)
+        {
+            const int64_t cell = InGrid.OccupiedCells[occupied];
+            const int64_t x = cell % InGrid.Dimensions[0];
+            const int64_t y = cell / InGrid.Dimensions[0] % InGrid.Dimensions[1];
+            const int64_t z = cell / (InGrid.Dimensions[0] * InGrid.Dimensions[1]);
+            for (int32_t first = InGrid.CellStarts[cell]; first < InGrid.CellStarts[cell + 1]; ++first)
+            {
+                const int32_t a = InGrid.Points[first];
+                if (InCircuits[a] == InLargestCircuit)
+                    continue;
+                for (const std::array<int64_t, 3>& offset : offsets)
+                {
+                    const int64_t otherX = x + offset[0];
+                    const int64_t otherY = y + offset[1];
+                    const int64_t otherZ = z + offset[2];
+                    if (otherX < 0 || otherY < 0 || otherZ < 0 || otherX >= InGrid.Dimensions[0]
+                        || otherY >= InGrid.Dimensions[1] || otherZ >= InGrid.Dimensions[2])
+                        continue;
+                    const int64_t otherCell = InGrid.GetCell(otherX, otherY, otherZ);
+                    const int32_t secondBegin = InGrid.CellStarts[otherCell];
+                    const int32_t secondEnd = InGrid.CellStarts[otherCell + 1];
+                    if (secondBegin == secondEnd)
+                        continue;
+                    distances2.resize(std::max<size_t>(distances2.size(), secondEnd - secondBegin));
+                    ComputeDistances2(InGrid.Cloud, InGrid.Cloud.X[first], InGrid.Cloud.Y[first], InGrid.Cloud.Z[first],
+                        secondBegin, secondEnd, distances2.data());
+                    for (int32_t second = secondBegin; second < secondEnd; ++second)
+                    {
+                        // A pair of two small circuit boxes is seen from both ends, keep it once
+                        const int32_t b = InGrid.Points[second];
+                        if (InCircuits[a] == InCircuits[b] || (InCircuits[b] != InLargestCircuit && b < a))
+                            continue;
+                        const int64_t distance2 = distances2[second - secondBegin];
+                        if (distance2 > InMinDistance2 && distance2 <= InMaxDistance2)
+                            edges.push_back({distance2, std::min(a, b), std::max(a, b)});
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<FEdge> edges;
+    for (const std::vector<FEdge>& block : blockEdges)
+        edges.insert(edges.end(), block.begin(), block.end());
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+// Kruskal over the edges in increasing distance, produced band by band with the band limit doubling each
+// time. Every band gets a grid with cells about as wide as the limit, so a band never looks further than two
+// cells away. Edges inside a circuit joined in an earlier band are never generated. Returns the edge that
+// leaves a single circuit, the longest edge of the minimum spanning tree, or nothing when boxes at distance
+// 0 can not be joined to anything else.
+std::optional<FEdge> FindFinalConnection(const FPointCloud& InCloud)
+{
+    DSU dsu(InCloud.GetCount());
+    size_t circuitCount = InCloud.GetCount();
+    std::vector<int32_t> circuits(InCloud.GetCount());
+    int64_t minDistance2 = 0;
+    FPointGrid grid = MakePointGrid(InCloud, 0);
+    double diagonal2 = 0;
+    for (int32_t axis = 0; axis < 3; ++axis)
+        diagonal2 += std::pow(grid.Maximum[axis] - grid.Minimum[axis], 2);
+    double limit = grid.CellSize;
+    while (circuitCount > 1 && static_cast<double>(minDistance2) <= diagonal2)
+    {
+        const int64_t maxDistance2 = static_cast<int64_t>(limit * limit);
+        if (grid.CellSize < limit)
+            grid = MakePointGrid(InCloud, limit);
+        int32_t largestCircuit = 0;
+        for (size_t index = 0; index < InCloud.GetCount(); ++index)
+        {
+            circuits[index] = dsu.find(static_cast<int>(index));
+            if (dsu.size[circuits[index]] > dsu.size[largestCircuit])
+                largestCircuit = circuits[index];
+        }
+        for (const FEdge& edge : CollectBandEdges(grid, circuits, largestCircuit, minDistance2, maxDistance2))
+        {
+            if (dsu.unite(edge.A, edge.B) && --circuitCount == 1)
+                return edge;
+        }
+        minDistance2 = maxDistance2;
+        limit *= 2;
+    }
+    return std::nullopt;
+}
+
+int64_t SolvePart2(const FPlayground& InPlayground)
+{
+    const FPointCloud& boxes = InPlayground.Boxes;
+    if (boxes.GetCount() < 2)
+        return 0;
+    const std::optional<FEdge> edge = FindFinalConnection(boxes);
+    if (!edge)
+        return 0;
+    return static_cast<int64_t>(boxes.X[edge->A]) * boxes.X[edge->B];
+}
+
+static const Aoc::TDayRegistrar Registrar(8, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day08/TestInput.txt", 40, 25272, 10},
+    {"Day08/Input.txt", 66640, 78894156, 1000},
+});
+
 }
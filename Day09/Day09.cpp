@@ -1,49 +1,571 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/point_xy.hpp>
-#include <boost/geometry/geometries/polygon.hpp>
 
-namespace bg = boost::geometry;
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
+#include "Parallel.h"
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+namespace Day09
+{
 
-void Day12(const std::string& InFileName, const int64_t InPart1Expected, const int64_t InPart2Expected)
+// Closed containment of axis aligned rectangles in the red tile loop, taken as the continuous polygon through
+// the tile centres like the covered_by check this replaced, not as a set of lattice tiles. The two differ where
+// the loop runs back on itself one tile apart: the tiles of such a notch are all on the loop, but the strip
+// between their centres is outside the polygon, so a rectangle across it is rejected here while a per tile
+// check would accept it. The distinct x and y coordinates split the plane into a compressed grid; the loop
+// only runs along grid lines, so every open cell between them is either fully inside or fully outside. A
+// rectangle with two red corners lies in the closed polygon exactly when none of the open cells it spans is
+// outside, which a 2D prefix sum answers in O(1).
+struct FContainmentIndex
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    int64_t part1Count = 0;
-    int64_t part2Count = 0;
-    std::vector<std::pair<int64_t, int64_t>> rectStartEndPoints;
-    
-    while (inputFile.is_open() && !inputFile.eof())
+    std::vector<int64_t> Xs;
+    std::vector<int64_t> Ys;
+    std::vector<int32_t> VertexX;           // compressed coordinates of every red tile
+    std::vector<int32_t> VertexY;
+    std::vector<uint8_t> Inside;            // open cells, (Xs.size() - 1) per row
+    std::vector<uint32_t> OutsidePrefix;    // outside open cells left of and below, Xs.size() per row
+
+    bool IsInside(int32_t InCellX, int32_t InCellY) const
+    {
+        const int32_t cellsPerRow = static_cast<int32_t>(Xs.size()) - 1;
+        return InCellX >= 0 && InCellX < cellsPerRow && InCellY >= 0 && InCellY < static_cast<int32_t>(Ys.size()) - 1
+            && Inside[static_cast<size_t>(InCellY) * cellsPerRow + InCellX];
+    }
+
+    uint32_t GetOutsidePrefix(int32_t InX, int32_t InY) const
+    {
+        return OutsidePrefix[static_cast<size_t>(InY) * Xs.size() + InX];
+    }
+
+    // The rectangle spanned by red tiles InFirst and InSecond
+    bool Contains(size_t InFirst, size_t InSecond) const
+    {
+        const int32_t minX = std::min(VertexX[InFirst], VertexX[InSecond]);
+        const int32_t maxX = std::max(VertexX[InFirst], VertexX[InSecond]);
+        const int32_t minY = std::min(VertexY[InFirst], VertexY[InSecond]);
+        const int32_t maxY = std::max(VertexY[InFirst], VertexY[InSecond]);
+        if (minX < maxX && minY < maxY)
+        {
+            return GetOutsidePrefix(maxX, maxY) - GetOutsidePrefix(minX, maxY) - GetOutsidePrefix(maxX, minY)
+                + GetOutsidePrefix(minX, minY) == 0;
+        }
+        // A line of tiles is covered when every piece of it borders an inside cell on one side
+        for (int32_t y = minY; y < maxY; ++y)
+        {
+            if (!IsInside(minX - 1, y) && !IsInside(minX, y))
+                return false;
+        }
+        for (int32_t x = minX; x < maxX; ++x)
+        {
+            if (!IsInside(x, minY - 1) && !IsInside(x, minY))
+                return false;
+        }
+        return true;
+    }
+};
+
+// O(n^2) at worst: every vertical edge toggles the inside parity of the cells right of it in the rows it
+// spans, a prefix XOR along each row then gives the inside cells
+FContainmentIndex MakeContainmentIndex(const std::vector<std::pair<int64_t, int64_t>>& InRedTiles)
+{
+    FContainmentIndex index;
+    for (const std::pair<int64_t, int64_t>& tile : InRedTiles)
+    {
+        index.Xs.push_back(tile.first);
+        index.Ys.push_back(tile.second);
+    }
+    for (std::vector<int64_t>* coordinates : {&index.Xs, &index.Ys})
+    {
+        std::sort(coordinates->begin(), coordinates->end());
+        coordinates->erase(std::unique(coordinates->begin(), coordinates->end()), coordinates->end());
+    }
+    for (const std::pair<int64_t, int64_t>& tile : InRedTiles)
+    {
+        index.VertexX.push_back(static_cast<int32_t>(std::lower_bound(index.Xs.begin(), index.Xs.end(), tile.first)
+            - index.Xs.begin()));
+        index.VertexY.push_back(static_cast<int32_t>(std::lower_bound(index.Ys.begin(), index.Ys.end(), tile.second)
+            - index.Ys.begin()));
+    }
+
+    const size_t cellsPerRow = std::max<size_t>(index.Xs.size(), 1) - 1;
+    const size_t cellRows = std::max<size_t>(index.Ys.size(), 1) - 1;
+    index.Inside.assign(cellsPerRow * cellRows, 0);
+    for (size_t vertex = 0; vertex < InRedTiles.size(); ++vertex)
+    {
+        const size_t next = (vertex + 1) % InRedTiles.size();
+        const int32_t x = index.VertexX[vertex];
+        if (x != index.VertexX[next] || x >= static_cast<int32_t>(cellsPerRow))
+            continue;
+        const int32_t minY = std::min(index.VertexY[vertex], index.VertexY[next]);
+        const int32_t maxY = std::max(index.VertexY[vertex], index.VertexY[next]);
+        for (int32_t y = minY; y < maxY; ++y)
+            index.Inside[y * cellsPerRow + x] ^= 1;
+    }
+    for (size_t y = 0; y < cellRows; ++y)
+    {
+        for (size_t x = 1; x < cellsPerRow; ++x)
+            index.Inside[y * cellsPerRow + x] ^= index.Inside[y * cellsPerRow + x - 1];
+    }
+
+    const size_t prefixPerRow = index.Xs.size();
+    index.OutsidePrefix.assign(prefixPerRow * index.Ys.size(), 0);
+    for (size_t y = 0; y < cellRows; ++y)
+    {
+        uint32_t rowOutside = 0;
+        for (size_t x = 0; x < cellsPerRow; ++x)
+        {
+            rowOutside += index.Inside[y * cellsPerRow + x] == 0;
+            index.OutsidePrefix[(y + 1) * prefixPerRow + x + 1] = index.OutsidePrefix[y * prefixPerRow + x + 1] + rowOutside;
+        }
+    }
+    return index;
+}
+
+// Axis aligned edges of one direction, sorted by their position on the other axis and kept in a merge sort
+// tree. Level L holds the edges sorted by Low inside every block of 2^L consecutive positions, with the
+// running maximum of High in that order, and the sorted Highs of the same blocks. A range of positions splits
+// into O(log n) blocks, each a contiguous slice of its level that is binary searched, and nothing is allocated
+// by a query.
+class FEdgeTree
+{
+public:
+    struct FEdge
+    {
+        int64_t Position = 0;
+        int64_t Low = 0;
+        int64_t High = 0;
+    };
+
+    FEdgeTree() = default;
+    explicit FEdgeTree(std::vector<FEdge> InEdges)
+    {
+        std::sort(InEdges.begin(), InEdges.end(), [](const FEdge& InFirst, const FEdge& InSecond)
+        {
+            return InFirst.Position < InSecond.Position;
+        });
+        for (const FEdge& edge : InEdges)
+            Positions.push_back(edge.Position);
+
+        std::vector<std::pair<int64_t, int64_t>> byLow;
+        std::vector<int64_t> highs;
+        for (const FEdge& edge : InEdges)
+        {
+            byLow.emplace_back(edge.Low, edge.High);
+            highs.push_back(edge.High);
+        }
+        const size_t count = InEdges.size();
+        for (size_t blockSize = 1; ; blockSize *= 2)
+        {
+            AddLevel(byLow, highs, blockSize);
+            if (blockSize >= count)
+                break;
+            // Merge neighbouring blocks into the next level
+            std::vector<std::pair<int64_t, int64_t>> mergedByLow(count);
+            std::vector<int64_t> mergedHighs(count);
+            for (size_t begin = 0; begin < count; begin += 2 * blockSize)
+            {
+                const size_t middle = std::min(count, begin + blockSize);
+                const size_t end = std::min(count, begin + 2 * blockSize);
+                std::merge(byLow.begin() + begin, byLow.begin() + middle, byLow.begin() + middle, byLow.begin() + end,
+                    mergedByLow.begin() + begin);
+                std::merge(highs.begin() + begin, highs.begin() + middle, highs.begin() + middle, highs.begin() + end,
+                    mergedHighs.begin() + begin);
+            }
+            byLow = std::move(mergedByLow);
+            highs = std::move(mergedHighs);
+        }
+    }
+
+    // Is there an edge with InMinPosition <= Position <= InMaxPosition, Low <= InMaxLow and High >= InMinHigh
+    bool AnyInRange(int64_t InMinPosition, int64_t InMaxPosition, int64_t InMaxLow, int64_t InMinHigh) const
+    {
+        const size_t begin = std::lower_bound(Positions.begin(), Positions.end(), InMinPosition) - Positions.begin();
+        const size_t end = std::upper_bound(Positions.begin(), Positions.end(), InMaxPosition) - Positions.begin();
+        bool isFound = false;
+        ForEachBlock(begin, end, [&](const FLevel& InLevel, size_t InSliceBegin, size_t InSliceEnd)
+        {
+            const auto lows = InLevel.Lows.begin();
+            const size_t lowCount = std::upper_bound(lows + InSliceBegin, lows + InSliceEnd, InMaxLow) - (lows + InSliceBegin);
+            isFound = lowCount > 0 && InLevel.MaxHighs[InSliceBegin + lowCount - 1] >= InMinHigh;
+            return !isFound;
+        });
+        return isFound;
+    }
+
+    // Number of edges with Position < InPosition and Low <= InAt < High, the crossings of a ray from InAt
+    // towards smaller positions
+    int64_t CountCrossings(int64_t InPosition, int64_t InAt) const
+    {
+        const size_t end = std::lower_bound(Positions.begin(), Positions.end(), InPosition) - Positions.begin();
+        int64_t crossings = 0;
+        ForEachBlock(0, end, [&](const FLevel& InLevel, size_t InSliceBegin, size_t InSliceEnd)
+        {
+            const auto lows = InLevel.Lows.begin();
+            const auto highs = InLevel.Highs.begin();
+            crossings += std::upper_bound(lows + InSliceBegin, lows + InSliceEnd, InAt) - (lows + InSliceBegin);
+            crossings -= std::upper_bound(highs + InSliceBegin, highs + InSliceEnd, InAt) - (highs + InSliceBegin);
+            return true;
+        });
+        return crossings;
+    }
+
+private:
+    struct FLevel
+    {
+        std::vector<int64_t> Lows;
+        std::vector<int64_t> MaxHighs;
+        std::vector<int64_t> Highs;
+    };
+
+    void AddLevel(const std::vector<std::pair<int64_t, int64_t>>& InByLow, const std::vector<int64_t>& InHighs,
+        size_t InBlockSize)
+    {
+        FLevel& level = Levels.emplace_back();
+        level.Highs = InHighs;
+        for (size_t index = 0; index < InByLow.size(); ++index)
+        {
+            level.Lows.push_back(InByLow[index].first);
+            const bool isBlockStart = index % InBlockSize == 0;
+            level.MaxHighs.push_back(isBlockStart ? InByLow[index].second
+                : std::max(level.MaxHighs.back(), InByLow[index].second));
+        }
+    }
+
+    // Splits [InBegin, InEnd) into whole blocks bottom up, InVisit returns false to stop early
+    template <typename TVisit>
+    void ForEachBlock(size_t InBegin, size_t InEnd, TVisit&& InVisit) const
+    {
+        for (size_t level = 0; InBegin < InEnd && level < Levels.size(); ++level)
+        {
+            if (InBegin & 1)
+            {
+                if (!InVisit(Levels[level], InBegin << level, (InBegin + 1) << level))
+                    return;
+                ++InBegin;
+            }
+            if (InEnd & 1)
+            {
+                --InEnd;
+                if (!InVisit(Levels[level], InEnd << level, (InEnd + 1) << level))
+                    return;
+            }
+            InBegin >>= 1;
+            InEnd >>= 1;
+        }
+    }
+
+    std::vector<int64_t> Positions;
+    std::vector<FLevel> Levels;
+};
+
+// Closed containment in the red tile loop straight from its edges, for the same continuous polygon as
+// FContainmentIndex. Coordinates are doubled so the centre of
+// any rectangle and the midpoint between two coordinates stay integers. A rectangle with an area lies in the
+// loop when no edge runs through its open interior (which then is all inside or all outside) and its centre
+// is inside by crossing parity.
+class FRectilinearIndex
+{
+public:
+    FRectilinearIndex() = default;
+    explicit FRectilinearIndex(const std::vector<std::pair<int64_t, int64_t>>& InRedTiles)
+    {
+        std::vector<FEdgeTree::FEdge> verticalEdges;
+        std::vector<FEdgeTree::FEdge> horizontalEdges;
+        for (size_t vertex = 0; vertex < InRedTiles.size(); ++vertex)
+        {
+            const std::pair<int64_t, int64_t>& start = InRedTiles[vertex];
+            const std::pair<int64_t, int64_t>& end = InRedTiles[(vertex + 1) % InRedTiles.size()];
+            if (start.first == end.first)
+            {
+                verticalEdges.push_back({2 * start.first, 2 * std::min(start.second, end.second),
+                    2 * std::max(start.second, end.second)});
+            }
+            else
+            {
+                horizontalEdges.push_back({2 * start.second, 2 * std::min(start.first, end.first),
+                    2 * std::max(start.first, end.first)});
+            }
+            Xs.push_back(2 * start.first);
+            Ys.push_back(2 * start.second);
+        }
+        for (std::vector<int64_t>* coordinates : {&Xs, &Ys})
+        {
+            std::sort(coordinates->begin(), coordinates->end());
+            coordinates->erase(std::unique(coordinates->begin(), coordinates->end()), coordinates->end());
+        }
+        Vertical = FEdgeTree(std::move(verticalEdges));
+        Horizontal = FEdgeTree(std::move(horizontalEdges));
+    }
+
+    // The point at doubled coordinates (InX, InY) is on the loop or inside it
+    bool IsInside(int64_t InX, int64_t InY) const
+    {
+        if (Vertical.AnyInRange(InX, InX, InY, InY) || Horizontal.AnyInRange(InY, InY, InX, InX))
+            return true;
+        return Vertical.CountCrossings(InX, InY) % 2 == 1;
+    }
+
+    // The rectangle spanned by two red tiles
+    bool Contains(const std::pair<int64_t, int64_t>& InFirst, const std::pair<int64_t, int64_t>& InSecond) const
+    {
+        const int64_t minX = 2 * std::min(InFirst.first, InSecond.first);
+        const int64_t maxX = 2 * std::max(InFirst.first, InSecond.first);
+        const int64_t minY = 2 * std::min(InFirst.second, InSecond.second);
+        const int64_t maxY = 2 * std::max(InFirst.second, InSecond.second);
+        if (minX < maxX && minY < maxY)
+        {
+            if (Vertical.AnyInRange(minX + 1, maxX - 1, maxY - 1, minY + 1)
+                || Horizontal.AnyInRange(minY + 1, maxY - 1, maxX - 1, minX + 1))
+                return false;
+            return Vertical.CountCrossings((minX + maxX) / 2, (minY + maxY) / 2) % 2 == 1;
+        }
+        // A line of tiles is checked piece by piece between the coordinates the loop turns at
+        if (minX < maxX)
+            return IsLineInside(Xs, minX, maxX, [&](int64_t InMiddle) { return IsInside(InMiddle, minY); });
+        return IsLineInside(Ys, minY, maxY, [&](int64_t InMiddle) { return IsInside(minX, InMiddle); });
+    }
+
+private:
+    template <typename TIsInside>
+    static bool IsLineInside(const std::vector<int64_t>& InCoordinates, int64_t InMin, int64_t InMax,
+        TIsInside&& InIsInside)
+    {
+        int64_t previous = InMin;
+        for (auto itr = std::upper_bound(InCoordinates.begin(), InCoordinates.end(), InMin); previous < InMax; ++itr)
+        {
+            const int64_t next = itr != InCoordinates.end() ? std::min(*itr, InMax) : InMax;
+            if (!InIsInside((previous + next) / 2))
+                return false;
+            previous = next;
+        }
+        return true;
+    }
+
+    FEdgeTree Vertical;      // Position is x, Low and High are y
+    FEdgeTree Horizontal;    // Position is y, Low and High are x
+    std::vector<int64_t> Xs;
+    std::vector<int64_t> Ys;
+};
+
+// Red tiles in loop order and the containment index over their loop
+struct FTileFloor
+{
+    std::vector<std::pair<int64_t, int64_t>> RedTiles;
+    FRectilinearIndex Index;
+};
+
+FTileFloor Parse(const std::string& InFileName)
+{
+    Aoc::FMappedFile inputFile(InFileName);
+    std::vector<int64_t> coordinates;
+    Aoc::AppendIntegers(inputFile.GetContents(), coordinates);
+    FTileFloor floor;
+    floor.RedTiles.reserve(coordinates.size() / 2);
+    for (size_t index = 0; index + 1 < coordinates.size(); index += 2)
+        floor.RedTiles.emplace_back(coordinates[index], coordinates[index + 1]);
+    floor.Index = FRectilinearIndex(floor.RedTiles);
+    return floor;
+}
+
+int64_t GetRectangleArea(const std::pair<int64_t, int64_t>& InFirst, const std::pair<int64_t, int64_t>& InSecond)
+{
+    return (std::abs(InSecond.first - InFirst.first) + 1) * (std::abs(InSecond.second - InFirst.second) + 1);
+}
+
+// The four staircases of tiles no other tile lies beyond in a diagonal direction, the only tiles a corner of
+// the largest rectangle in that direction can be. All are ordered by x ascending, lower left and upper right
+// with y descending, upper left and lower right with y ascending. One sort feeds all four: the left ones keep
+// the new y extremes walking x upwards, the right ones walking x downwards.
+struct FFrontiers
+{
+    std::vector<std::pair<int64_t, int64_t>> LowerLeft;
+    std::vector<std::pair<int64_t, int64_t>> UpperLeft;
+    std::vector<std::pair<int64_t, int64_t>> LowerRight;
+    std::vector<std::pair<int64_t, int64_t>> UpperRight;
+};
+
+FFrontiers GetFrontiers(std::vector<std::pair<int64_t, int64_t>> InTiles)
+{
+    std::sort(InTiles.begin(), InTiles.end());
+    FFrontiers frontiers;
+    for (const std::pair<int64_t, int64_t>& tile : InTiles)
     {
-        char delimiter = ',';
-        int64_t x = -1, y = -1;
-        inputFile >> x >> delimiter >> y; 
-        std::getline(inputFile, inputLine);
-        rectStartEndPoints.emplace_back(x, y);
+        if (frontiers.LowerLeft.empty() || tile.second < frontiers.LowerLeft.back().second)
+            frontiers.LowerLeft.push_back(tile);
+        if (frontiers.UpperLeft.empty() || tile.second > frontiers.UpperLeft.back().second)
+            frontiers.UpperLeft.push_back(tile);
     }
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    bg::model::polygon<bg::model::d2::point_xy<int>> part2Shape;
-    for (const auto& point : rectStartEndPoints)
+    for (auto itr = InTiles.rbegin(); itr != InTiles.rend(); ++itr)
     {
-        bg::append(part2Shape, bg::model::d2::point_xy<int64_t>(point.first, point.second));
+        if (frontiers.LowerRight.empty() || itr->second < frontiers.LowerRight.back().second)
+            frontiers.LowerRight.push_back(*itr);
+        if (frontiers.UpperRight.empty() || itr->second > frontiers.UpperRight.back().second)
+            frontiers.UpperRight.push_back(*itr);
     }
-    bg::correct(part2Shape);
-    
-    for (const std::pair<int64_t, int64_t>& startPos : rectStartEndPoints)
+    std::reverse(frontiers.LowerRight.begin(), frontiers.LowerRight.end());
+    std::reverse(frontiers.UpperRight.begin(), frontiers.UpperRight.end());
+    return frontiers;
+}
+
+// Largest rectangle with its lower left corner on one staircase and its upper right corner on the other.
+// Walking the lower left corners by x, the best upper right partner only ever moves right, so the corner in
+// the middle scans the whole candidate range and the halves either side only the part of it left of or right
+// of its best partner, O((n + m) log n) overall. Pairs where the partner lies left of or below the corner get
+// an area of zero or less, so they never win, and no partner can lie both left and below since it would not be
+// on its staircase.
+int64_t FindLargestOpposingArea(const std::vector<std::pair<int64_t, int64_t>>& InLowerLeft,
+    const std::vector<std::pair<int64_t, int64_t>>& InUpperRight)
+{
+    int64_t largest = 0;
+    const std::function<void(size_t, size_t, size_t, size_t)> search =
+        [&](size_t InBegin, size_t InEnd, size_t InPartnerBegin, size_t InPartnerEnd)
     {
-        for (const std::pair<int64_t, int64_t>& endPosition : rectStartEndPoints)
+        if (InBegin >= InEnd)
+            return;
+        const size_t middle = InBegin + (InEnd - InBegin) / 2;
+        const std::pair<int64_t, int64_t>& corner = InLowerLeft[middle];
+        size_t bestPartner = InPartnerBegin;
+        int64_t bestArea = std::numeric_limits<int64_t>::min();
+        for (size_t partner = InPartnerBegin; partner <= InPartnerEnd; ++partner)
+        {
+            const int64_t area = (InUpperRight[partner].first - corner.first + 1)
+                * (InUpperRight[partner].second - corner.second + 1);
+            if (area > bestArea)
+            {
+                bestArea = area;
+                bestPartner = partner;
+            }
+        }
+        largest = std::max(largest, bestArea);
+        search(InBegin, middle, InPartnerBegin, bestPartner);
+        search(middle + 1, InEnd, bestPartner, InPartnerEnd);
+    };
+    if (!InLowerLeft.empty() && !InUpperRight.empty())
+        search(0, InLowerLeft.size(), 0, InUpperRight.size() - 1);
+    return largest;
+}
+
+struct FRectangleResult
+{
+    int64_t Largest = 0;             // part 1, any two red tiles, only when tracked
+    int64_t LargestContained = 0;    // part 2, inside the loop as well
+};
+
+// Both parts in one branch and bound pass. No rectangle with tile a can be larger than the one reaching the
+// farthest corner of the bounding box, so the tiles are visited by that bound from large to small: a worker
+// takes the next tile and pairs it with the tiles after it until their bound drops to the best contained
+// area found so far. Once the bound of the next tile is there no pair is left that can win either part.
+// The containment check only runs for rectangles larger than the shared best. Part 1 defaults to the staircase
+// search, so only the "bound" variant sets InTracksLargest and uses this as the one pass for both parts.
+FRectangleResult FindLargestRectangles(const FTileFloor& InFloor, bool InTracksLargest)
+{
+    const std::vector<std::pair<int64_t, int64_t>>& tiles = InFloor.RedTiles;
+    FRectangleResult result;
+    if (tiles.size() < 2)
+        return result;
+
+    int64_t minX = tiles[0].first, maxX = tiles[0].first, minY = tiles[0].second, maxY = tiles[0].second;
+    for (const std::pair<int64_t, int64_t>& tile : tiles)
+    {
+        minX = std::min(minX, tile.first);
+        maxX = std::max(maxX, tile.first);
+        minY = std::min(minY, tile.second);
+        maxY = std::max(maxY, tile.second);
+    }
+    std::vector<std::pair<int64_t, int32_t>> bounds;
+    bounds.reserve(tiles.size());
+    for (size_t index = 0; index < tiles.size(); ++index)
+    {
+        const int64_t width = std::max(tiles[index].first - minX, maxX - tiles[index].first) + 1;
+        const int64_t height = std::max(tiles[index].second - minY, maxY - tiles[index].second) + 1;
+        bounds.emplace_back(width * height, static_cast<int32_t>(index));
+    }
+    std::sort(bounds.begin(), bounds.end(), std::greater<>());
+
+    // The tiles in bound order, so the inner loop walks memory front to back
+    std::vector<std::pair<int64_t, int64_t>> rankedTiles;
+    rankedTiles.reserve(tiles.size());
+    for (const std::pair<int64_t, int32_t>& bound : bounds)
+        rankedTiles.push_back(tiles[bound.second]);
+
+    std::atomic<int64_t> largest = 0;
+    std::atomic<int64_t> largestContained = 0;
+    std::atomic<size_t> nextRank = 0;
+    std::atomic<int64_t> checkCount = 0;
+    Aoc::RunBlocks(static_cast<size_t>(Aoc::GetWorkerCount()), [&](size_t)
+    {
+        int64_t localLargest = 0;
+        int64_t localChecks = 0;
+        for (size_t rank = nextRank++; rank < bounds.size(); rank = nextRank++)
+        {
+            int64_t best = largestContained.load(std::memory_order_relaxed);
+            if (bounds[rank].first <= best)
+                break;
+            const std::pair<int64_t, int64_t> tile = rankedTiles[rank];
+            for (size_t otherRank = rank + 1; otherRank < bounds.size() && bounds[otherRank].first > best; ++otherRank)
+            {
+                const int64_t area = GetRectangleArea(tile, rankedTiles[otherRank]);
+                if (InTracksLargest)
+                    localLargest = std::max(localLargest, area);
+                if (area <= best)
+                    continue;
+                ++localChecks;
+                if (InFloor.Index.Contains(tile, rankedTiles[otherRank]))
+                    Aoc::AtomicMax(largestContained, area);
+                best = largestContained.load(std::memory_order_relaxed);
+            }
+        }
+        Aoc::AtomicMax(largest, localLargest);
+        checkCount += localChecks;
+    });
+    Aoc::SetCounter("checked", checkCount);
+
+    result.Largest = largest;
+    result.LargestContained = largestContained;
+    return result;
+}
+
+// The largest rectangle spans from a lower left to an upper right corner or from an upper left to a lower
+// right one, which mirrored in y is the same search
+int64_t SolvePart1(const FTileFloor& InFloor)
+{
+    if (InFloor.RedTiles.size() < 2)
+        return 0;
+    FFrontiers frontiers = GetFrontiers(InFloor.RedTiles);
+    for (std::vector<std::pair<int64_t, int64_t>>* frontier : {&frontiers.UpperLeft, &frontiers.LowerRight})
+    {
+        for (std::pair<int64_t, int64_t>& tile : *frontier)
+            tile.second = -tile.second;
+    }
+    return std::max(FindLargestOpposingArea(frontiers.LowerLeft, frontiers.UpperRight),
+        FindLargestOpposingArea(frontiers.UpperLeft, frontiers.LowerRight));
+}
+
+int64_t SolvePart1Bound(const FTileFloor& InFloor)
+{
+    return FindLargestRectangles(InFloor, true).Largest;
+}
+
+int64_t SolvePart2(const FTileFloor& InFloor)
+{
+    return FindLargestRectangles(InFloor, false).LargestContained;
+}
+
+// Every pair of red tiles, without the pruning
+int64_t SolvePart1Pairs(const FTileFloor& InFloor)
+{
+    const std::vector<std::pair<int64_t, int64_t>>& InRectStartEndPoints = InFloor.RedTiles;
+    int64_t part1Count = 0;
+    for (const std::pair<int64_t, int64_t>& startPos : InRectStartEndPoints)
+    {
+        for (const std::pair<int64_t, int64_t>& endPosition : InRectStartEndPoints)
         {
             if (startPos == endPosition)
                 continue;
@@ -51,32 +573,49 @@ void Day12(const std::string& InFileName, const int64_t InPart1Expected, const i
             auto xDiff = std::abs(endPosition.first - startPos.first) + 1;
             auto yDiff = std::abs(endPosition.second - startPos.second) + 1;
             part1Count = std::max(xDiff * yDiff, part1Count);
-            
-            bg::model::polygon<bg::model::d2::point_xy<int64_t>> rectPoly;
-            bg::append(rectPoly, bg::model::d2::point_xy<int64_t>(startPos.first, startPos.second));
-            bg::append(rectPoly, bg::model::d2::point_xy<int64_t>(endPosition.first, startPos.second));
-            bg::append(rectPoly, bg::model::d2::point_xy<int64_t>(endPosition.first, endPosition.second));
-            bg::append(rectPoly, bg::model::d2::point_xy<int64_t>(startPos.first, endPosition.second));
-            bg::correct(rectPoly);
-            if (bg::covered_by(rectPoly, part2Shape) || bg::touches(rectPoly, part2Shape))
-            {
-                part2Count = std::max(xDiff * yDiff, part2Count);
-            }
         }
     }
-    
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part1Count == InPart1Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part2Count == InPart2Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
+    return part1Count;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+int64_t SolvePart2Pairs(const FTileFloor& InFloor)
 {
-    Day12("TestInput.txt", 50, 24);
-    Day12("Input.txt", 4749929916,1572047142);
-    return 0;
+    int64_t part2Count = 0;
+    for (size_t first = 0; first < InFloor.RedTiles.size(); ++first)
+    {
+        for (size_t second = first + 1; second < InFloor.RedTiles.size(); ++second)
+        {
+            const int64_t area = GetRectangleArea(InFloor.RedTiles[first], InFloor.RedTiles[second]);
+            if (area > part2Count && InFloor.Index.Contains(InFloor.RedTiles[first], InFloor.RedTiles[second]))
+                part2Count = area;
+        }
+    }
+    return part2Count;
+}
+
+// Every pair against the compressed prefix sum index, built here since only this variant uses it
+int64_t SolvePart2Prefix(const FTileFloor& InFloor)
+{
+    const FContainmentIndex index = MakeContainmentIndex(InFloor.RedTiles);
+    int64_t part2Count = 0;
+    for (size_t first = 0; first < InFloor.RedTiles.size(); ++first)
+    {
+        for (size_t second = first + 1; second < InFloor.RedTiles.size(); ++second)
+        {
+            if (index.Contains(first, second))
+                part2Count = std::max(GetRectangleArea(InFloor.RedTiles[first], InFloor.RedTiles[second]), part2Count);
+        }
+    }
+    return part2Count;
+}
+
+static const Aoc::TDayRegistrar Registrar(9, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day09/TestInput.txt", 50, 24},
+    {"Day09/Input.txt", 4749929916, 1572047142},
+});
+static const Aoc::TVariantRegistrar PairsPart1(9, 1, "pairs", &SolvePart1Pairs);
+static const Aoc::TVariantRegistrar BoundPart1(9, 1, "bound", &SolvePart1Bound);
+static const Aoc::TVariantRegistrar PairsPart2(9, 2, "pairs", &SolvePart2Pairs);
+static const Aoc::TVariantRegistrar PrefixPart2(9, 2, "prefix", &SolvePart2Prefix);
+
 }
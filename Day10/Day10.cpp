@@ -1,24 +1,29 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
+#include <bit>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <limits>
 #include <map>
-#include <regex>
-#include <sstream>
+#include <numeric>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include <Eigen/Dense>
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
 
-
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+namespace Day10
+{
 
 struct Machine
 {
     std::string Lights;
     std::vector<std::vector<int32_t>> Buttons;
     std::vector<int32_t> JOltageRequirements;
+    uint64_t LightMask = 0;                 // bit i set when light i has to end up on
+    std::vector<uint64_t> ButtonMasks;      // bit i set when the button toggles light i
 };
 
 struct Part1Leaf
@@ -31,16 +36,6 @@ struct Part1Leaf
     int Depth = -1;
 };
 
-struct Part2Leaf
-{
-    Part2Leaf(const std::vector<int32_t> InEnergyLevels, int InDepth, const std::vector<int32_t>& InParent)
-        : EnergyLevels(InEnergyLevels), Parent(InParent), Depth(InDepth) 
-    {}
-    std::vector<int32_t> EnergyLevels;
-    std::vector<int32_t> Parent;
-    int Depth = -1;
-};
-
 std::string CalculateNewLight(const std::string& InString, const std::vector<int32_t>& InButtonCombo)
 {
     std::string returnString = InString;
@@ -54,19 +49,6 @@ std::string CalculateNewLight(const std::string& InString, const std::vector<int
     return returnString;
 }
 
-std::vector<int32_t> CalculateNewEnergy(const std::vector<int32_t>& InCombo, const std::vector<int32_t>& InButtonCombo)
-{
-    std::vector<int32_t> newCombo = InCombo;
-    for (int32_t buttonCombo : InButtonCombo)
-    {
-        if (buttonCombo >= 0 && buttonCombo < InCombo.size())
-        {
-            newCombo[buttonCombo]++;
-        }
-    }
-    return newCombo;
-}
-
 int64_t FindSmallestButtonCombo(const std::vector<Machine>::value_type& machine)
 {
     std::map<std::string, Part1Leaf> leaves;
@@ -95,91 +77,646 @@ int64_t FindSmallestButtonCombo(const std::vector<Machine>::value_type& machine)
     return 0;
 }
 
+// Pressing a button twice undoes it, so part 1 is the smallest set of buttons whose masks xor to the lights,
+// a linear system over GF(2) with one unknown per button. Gaussian elimination gives one solution and a null
+// space basis; every solution is that one xor a combination of the basis, walked in Gray code order so each
+// step is a single xor. With more free buttons than pivots it is cheaper to meet in the middle over the
+// buttons themselves: all subsets of the first half sorted by the lights they toggle, looked up from every
+// subset of the second half. Its table holds at most 2^MaxMeetInMiddleBits entries (64 MB); machines above
+// that walk the null space instead, which allocates nothing. Machines with more than 64 lights or buttons,
+// or whose walk would take more than 2^MaxNullSpaceBits steps, are rejected on stderr and count as 0.
+int64_t FindFewestPresses(uint64_t InLightMask, const std::vector<uint64_t>& InButtonMasks)
+{
+    const size_t buttonCount = InButtonMasks.size();
+    constexpr size_t MaxMeetInMiddleBits = 22;
+    constexpr size_t MaxNullSpaceBits = 32;
+    if (buttonCount == 0)
+        return 0;
+    if (buttonCount > 64)
+    {
+        std::fprintf(stderr, "Day 10: a machine with %zu buttons is over the limit of 64\n", buttonCount);
+        return 0;
+    }
+
+    // Row per light: the buttons toggling it and whether it has to end up on
+    std::vector<uint64_t> rows;
+    std::vector<bool> targets;
+    for (size_t light = 0; light < 64; ++light)
+    {
+        uint64_t row = 0;
+        for (size_t button = 0; button < buttonCount; ++button)
+            row |= ((InButtonMasks[button] >> light) & 1) << button;
+        const bool bIsOn = (InLightMask >> light) & 1;
+        if (row != 0 || bIsOn)
+        {
+            rows.push_back(row);
+            targets.push_back(bIsOn);
+        }
+    }
+
+    // Reduced row echelon form, pivotButtons[r] is the button pivoting row r
+    std::vector<size_t> pivotButtons;
+    uint64_t freeButtons = buttonCount == 64 ? ~0ull : (1ull << buttonCount) - 1;
+    for (size_t button = 0; button < buttonCount && pivotButtons.size() < rows.size(); ++button)
+    {
+        const size_t rank = pivotButtons.size();
+        size_t pivot = rank;
+        while (pivot < rows.size() && !((rows[pivot] >> button) & 1))
+            ++pivot;
+        if (pivot == rows.size())
+            continue;
+        std::swap(rows[rank], rows[pivot]);
+        const bool pivotTarget = targets[pivot];
+        targets[pivot] = targets[rank];
+        targets[rank] = pivotTarget;
+        for (size_t row = 0; row < rows.size(); ++row)
+        {
+            if (row != rank && ((rows[row] >> button) & 1))
+            {
+                rows[row] ^= rows[rank];
+                targets[row] = targets[row] != targets[rank];
+            }
+        }
+        pivotButtons.push_back(button);
+        freeButtons &= ~(1ull << button);
+    }
+    for (size_t row = pivotButtons.size(); row < rows.size(); ++row)
+    {
+        if (targets[row])
+            return 0;
+    }
+
+    const size_t rank = pivotButtons.size();
+    const size_t freeCount = buttonCount - rank;
+    const size_t firstHalf = buttonCount / 2;
+    if (freeCount <= rank || freeCount <= 20 || firstHalf > MaxMeetInMiddleBits)
+    {
+        if (freeCount > MaxNullSpaceBits)
+        {
+            std::fprintf(stderr, "Day 10: a machine with %zu free buttons is over the search limit\n", freeCount);
+            return 0;
+        }
+
+        // Free buttons unpressed, pivots straight from the reduced rows
+        uint64_t solution = 0;
+        for (size_t row = 0; row < rank; ++row)
+            solution |= static_cast<uint64_t>(targets[row]) << pivotButtons[row];
+        // Pressing a free button flips it and every pivot whose row contains it
+        std::vector<uint64_t> basis;
+        for (uint64_t remaining = freeButtons; remaining != 0; remaining &= remaining - 1)
+        {
+            const uint64_t freeBit = remaining & (~remaining + 1);
+            uint64_t vector = freeBit;
+            for (size_t row = 0; row < rank; ++row)
+            {
+                if (rows[row] & freeBit)
+                    vector |= 1ull << pivotButtons[row];
+            }
+            basis.push_back(vector);
+        }
+        int64_t fewest = std::popcount(solution);
+        for (uint64_t step = 1; step < (1ull << freeCount); ++step)
+        {
+            solution ^= basis[std::countr_zero(step)];
+            fewest = std::min<int64_t>(fewest, std::popcount(solution));
+        }
+        return fewest;
+    }
+
+    std::vector<std::pair<uint64_t, int32_t>> firstToggles;
+    firstToggles.reserve(1ull << firstHalf);
+    uint64_t toggled = 0;
+    firstToggles.emplace_back(0, 0);
+    for (uint64_t step = 1; step < (1ull << firstHalf); ++step)
+    {
+        toggled ^= InButtonMasks[std::countr_zero(step)];
+        const uint64_t gray = step ^ (step >> 1);
+        firstToggles.emplace_back(toggled, std::popcount(gray));
+    }
+    std::sort(firstToggles.begin(), firstToggles.end());
+
+    int64_t fewest = std::numeric_limits<int64_t>::max();
+    const size_t secondHalf = buttonCount - firstHalf;
+    toggled = 0;
+    for (uint64_t step = 0; step < (1ull << secondHalf); ++step)
+    {
+        if (step != 0)
+            toggled ^= InButtonMasks[firstHalf + std::countr_zero(step)];
+        const uint64_t wanted = InLightMask ^ toggled;
+        const auto match = std::lower_bound(firstToggles.begin(), firstToggles.end(), std::make_pair(wanted, 0));
+        if (match != firstToggles.end() && match->first == wanted)
+            fewest = std::min<int64_t>(fewest, match->second + std::popcount(step ^ (step >> 1)));
+    }
+    return fewest == std::numeric_limits<int64_t>::max() ? 0 : fewest;
+}
+
+// Dense two phase simplex, minimises InCost . y subject to InRows y <= InLimits and y >= 0. Returns false
+// when nothing is feasible or the minimum is unbounded, otherwise OutValue and OutSolution hold the optimum.
+bool MinimiseLinear(const std::vector<std::vector<double>>& InRows, const std::vector<double>& InLimits,
+    const std::vector<double>& InCost, double& OutValue, std::vector<double>& OutSolution)
+{
+    constexpr double epsilon = 1e-9;
+    const size_t rowCount = InRows.size();
+    const size_t columnCount = InCost.size();
+    // Tableau maximising -InCost, column columnCount is the phase one variable, the last one the limits
+    std::vector<std::vector<double>> table(rowCount + 2, std::vector<double>(columnCount + 2, 0.0));
+    std::vector<int64_t> basic(rowCount);
+    std::vector<int64_t> nonBasic(columnCount + 1);
+    for (size_t row = 0; row < rowCount; ++row)
+    {
+        for (size_t column = 0; column < columnCount; ++column)
+            table[row][column] = InRows[row][column];
+        table[row][columnCount] = -1.0;
+        table[row][columnCount + 1] = InLimits[row];
+        basic[row] = static_cast<int64_t>(columnCount + row);
+    }
+    for (size_t column = 0; column < columnCount; ++column)
+    {
+        table[rowCount][column] = InCost[column];
+        nonBasic[column] = static_cast<int64_t>(column);
+    }
+    nonBasic[columnCount] = -1;
+    table[rowCount + 1][columnCount] = 1.0;
+
+    const auto pivot = [&](size_t InRow, size_t InColumn)
+    {
+        const double inverse = 1.0 / table[InRow][InColumn];
+        for (size_t row = 0; row < rowCount + 2; ++row)
+        {
+            if (row == InRow || table[row][InColumn] == 0.0)
+                continue;
+            const double factor = table[row][InColumn] * inverse;
+            for (size_t column = 0; column < columnCount + 2; ++column)
+            {
+                if (column != InColumn)
+                    table[row][column] -= table[InRow][column] * factor;
+            }
+            table[row][InColumn] = -factor;
+        }
+        for (size_t column = 0; column < columnCount + 2; ++column)
+        {
+            if (column != InColumn)
+                table[InRow][column] *= inverse;
+        }
+        table[InRow][InColumn] = inverse;
+        std::swap(basic[InRow], nonBasic[InColumn]);
+    };
+
+    // Bland's rule on the objective row, returns false when unbounded
+    const auto optimise = [&](size_t InObjectiveRow, bool bIsPhaseTwo)
+    {
+        for (;;)
+        {
+            size_t entering = columnCount + 1;
+            for (size_t column = 0; column <= columnCount; ++column)
+            {
+                if (bIsPhaseTwo && nonBasic[column] == -1)
+                    continue;
+                if (entering > columnCount || table[InObjectiveRow][column] < table[InObjectiveRow][entering]
+                    || (table[InObjectiveRow][column] == table[InObjectiveRow][entering] && nonBasic[column] < nonBasic[entering]))
+                    entering = column;
+            }
+            if (table[InObjectiveRow][entering] > -epsilon)
+                return true;
+            size_t leaving = rowCount;
+            for (size_t row = 0; row < rowCount; ++row)
+            {
+                if (table[row][entering] < epsilon)
+                    continue;
+                if (leaving == rowCount)
+                {
+                    leaving = row;
+                    continue;
+                }
+                const double ratio = table[row][columnCount + 1] / table[row][entering];
+                const double leavingRatio = table[leaving][columnCount + 1] / table[leaving][entering];
+                if (ratio < leavingRatio || (ratio == leavingRatio && basic[row] < basic[leaving]))
+                    leaving = row;
+            }
+            if (leaving == rowCount)
+                return false;
+            pivot(leaving, entering);
+        }
+    };
+
+    // Phase one only when the origin breaks a limit
+    size_t lowestRow = 0;
+    for (size_t row = 1; row < rowCount; ++row)
+    {
+        if (table[row][columnCount + 1] < table[lowestRow][columnCount + 1])
+            lowestRow = row;
+    }
+    if (rowCount > 0 && table[lowestRow][columnCount + 1] < -epsilon)
+    {
+        pivot(lowestRow, columnCount);
+        if (!optimise(rowCount + 1, false) || table[rowCount + 1][columnCount + 1] < -epsilon)
+            return false;
+        for (size_t row = 0; row < rowCount; ++row)
+        {
+            if (basic[row] != -1)
+                continue;
+            size_t entering = 0;
+            for (size_t column = 1; column <= columnCount; ++column)
+            {
+                if (table[row][column] < table[row][entering]
+                    || (table[row][column] == table[row][entering] && nonBasic[column] < nonBasic[entering]))
+                    entering = column;
+            }
+            pivot(row, entering);
+        }
+    }
+    if (!optimise(rowCount, true))
+        return false;
+
+    OutValue = -table[rowCount][columnCount + 1];
+    OutSolution.assign(columnCount, 0.0);
+    for (size_t row = 0; row < rowCount; ++row)
+    {
+        if (basic[row] >= 0 && basic[row] < static_cast<int64_t>(columnCount))
+            OutSolution[basic[row]] = table[row][columnCount + 1];
+    }
+    return true;
+}
+
+int64_t FloorDivide(int64_t InNumerator, int64_t InDenominator)
+{
+    const int64_t quotient = InNumerator / InDenominator;
+    return quotient * InDenominator != InNumerator && (InNumerator < 0) != (InDenominator < 0) ? quotient - 1 : quotient;
+}
+
+int64_t CeilDivide(int64_t InNumerator, int64_t InDenominator)
+{
+    return -FloorDivide(-InNumerator, InDenominator);
+}
+
+// Counters times presses has to equal the joltages, after elimination every pivot button is
+// (Remainders[p] - sum Coefficients[p][f] * presses of free button f) / Divisors[p] with Divisors[p] > 0
+struct FJoltageSystem
+{
+    std::vector<int64_t> Divisors;
+    std::vector<int64_t> Remainders;
+    std::vector<std::vector<int64_t>> Coefficients;
+    std::vector<int64_t> FreeLimits;        // no button can be pressed more often than its lowest counter
+    std::vector<double> FreeWeights;        // total presses gained per press of the free button
+    bool bIsSolvable = true;
+};
+
+// Fraction free Gauss Jordan elimination, rows are kept small by dividing out their gcd
+FJoltageSystem MakeJoltageSystem(const Machine& InMachine)
+{
+    const size_t counterCount = InMachine.JOltageRequirements.size();
+    const size_t buttonCount = InMachine.Buttons.size();
+    std::vector<std::vector<int64_t>> rows(counterCount, std::vector<int64_t>(buttonCount + 1, 0));
+    std::vector<int64_t> limits(buttonCount, 0);
+    for (size_t button = 0; button < buttonCount; ++button)
+    {
+        bool bIsFirst = true;
+        for (int32_t counter : InMachine.Buttons[button])
+        {
+            if (counter < 0 || counter >= static_cast<int32_t>(counterCount))
+                continue;
+            rows[counter][button] = 1;
+            limits[button] = bIsFirst ? InMachine.JOltageRequirements[counter]
+                : std::min<int64_t>(limits[button], InMachine.JOltageRequirements[counter]);
+            bIsFirst = false;
+        }
+    }
+    for (size_t counter = 0; counter < counterCount; ++counter)
+        rows[counter][buttonCount] = InMachine.JOltageRequirements[counter];
+
+    std::vector<size_t> pivotButtons;
+    std::vector<size_t> freeButtons;
+    for (size_t button = 0; button < buttonCount; ++button)
+    {
+        const size_t rank = pivotButtons.size();
+        size_t pivot = rank;
+        while (pivot < counterCount && rows[pivot][button] == 0)
+            ++pivot;
+        if (pivot == counterCount)
+        {
+            freeButtons.push_back(button);
+            continue;
+        }
+        std::swap(rows[rank], rows[pivot]);
+        if (rows[rank][button] < 0)
+        {
+            for (int64_t& value : rows[rank])
+                value = -value;
+        }
+        for (size_t row = 0; row < counterCount; ++row)
+        {
+            const int64_t factor = rows[row][button];
+            if (row == rank || factor == 0)
+                continue;
+            int64_t divisor = 0;
+            for (size_t column = 0; column <= buttonCount; ++column)
+            {
+                rows[row][column] = rows[row][column] * rows[rank][button] - rows[rank][column] * factor;
+                divisor = std::gcd(divisor, rows[row][column]);
+            }
+            if (divisor > 1)
+            {
+                for (int64_t& value : rows[row])
+                    value /= divisor;
+            }
+        }
+        pivotButtons.push_back(button);
+    }
+
+    FJoltageSystem system;
+    for (size_t row = pivotButtons.size(); row < counterCount; ++row)
+    {
+        if (rows[row][buttonCount] != 0)
+            system.bIsSolvable = false;
+    }
+    for (size_t freeButton : freeButtons)
+    {
+        system.FreeLimits.push_back(limits[freeButton]);
+        system.FreeWeights.push_back(1.0);
+    }
+    for (size_t row = 0; row < pivotButtons.size(); ++row)
+    {
+        const int64_t divisor = rows[row][pivotButtons[row]];
+        system.Divisors.push_back(divisor);
+        system.Remainders.push_back(rows[row][buttonCount]);
+        std::vector<int64_t>& coefficients = system.Coefficients.emplace_back();
+        for (size_t free = 0; free < freeButtons.size(); ++free)
+        {
+            coefficients.push_back(rows[row][freeButtons[free]]);
+            system.FreeWeights[free] -= static_cast<double>(coefficients.back()) / divisor;
+        }
+    }
+    return system;
+}
+
+// Branch and bound over the free buttons in order. Every node solves the linear relaxation of the buttons
+// still open; its optimum bounds the node and its value for the next free button is where the children
+// start. The relaxed optimum is convex in that value, so each direction walks outwards until a child is
+// infeasible or bounded out. The last free button needs no relaxation, the pivots limit it to an interval
+// and the total is linear in it, so the interval is scanned from its cheap end for the first value that
+// makes every pivot a whole number.
+class FJoltageSearch
+{
+public:
+    explicit FJoltageSearch(const FJoltageSystem& InSystem)
+        : System(InSystem), Remainders(InSystem.Remainders), Presses(InSystem.FreeLimits.size(), 0)
+    {}
+
+    int64_t Run()
+    {
+        if (!System.bIsSolvable)
+            return 0;
+        if (Presses.empty())
+        {
+            int64_t pivotTotal = 0;
+            return GetPivotTotal(pivotTotal) ? pivotTotal : 0;
+        }
+        double bound = 0.0;
+        std::vector<double> relaxed;
+        if (GetRelaxedBound(0, bound, relaxed))
+            Search(0, relaxed);
+        return Best == std::numeric_limits<int64_t>::max() ? 0 : Best;
+    }
+
+private:
+    // Pivot presses for the current Remainders, false unless all are whole and non negative
+    bool GetPivotTotal(int64_t& OutTotal) const
+    {
+        OutTotal = 0;
+        for (size_t pivot = 0; pivot < Remainders.size(); ++pivot)
+        {
+            if (Remainders[pivot] < 0 || Remainders[pivot] % System.Divisors[pivot] != 0)
+                return false;
+            OutTotal += Remainders[pivot] / System.Divisors[pivot];
+        }
+        return true;
+    }
+
+    void Press(size_t InFree, int64_t InCount)
+    {
+        for (size_t pivot = 0; pivot < Remainders.size(); ++pivot)
+            Remainders[pivot] -= System.Coefficients[pivot][InFree] * InCount;
+        Presses[InFree] += InCount;
+        FreeTotal += InCount;
+    }
+
+    // Lower bound on the total with the free buttons before InFirst fixed, false when infeasible
+    bool GetRelaxedBound(size_t InFirst, double& OutBound, std::vector<double>& OutSolution)
+    {
+        const size_t openCount = Presses.size() - InFirst;
+        Rows.clear();
+        Limits.clear();
+        Cost.assign(System.FreeWeights.begin() + InFirst, System.FreeWeights.end());
+        double fixedTotal = static_cast<double>(FreeTotal);
+        for (size_t pivot = 0; pivot < Remainders.size(); ++pivot)
+        {
+            const double divisor = static_cast<double>(System.Divisors[pivot]);
+            std::vector<double>& row = Rows.emplace_back(openCount);
+            for (size_t open = 0; open < openCount; ++open)
+                row[open] = System.Coefficients[pivot][InFirst + open] / divisor;
+            Limits.push_back(Remainders[pivot] / divisor);
+            fixedTotal += Remainders[pivot] / divisor;
+        }
+        for (size_t open = 0; open < openCount; ++open)
+        {
+            std::vector<double>& row = Rows.emplace_back(openCount, 0.0);
+            row[open] = 1.0;
+            Limits.push_back(static_cast<double>(System.FreeLimits[InFirst + open]));
+        }
+        double relaxed = 0.0;
+        if (!MinimiseLinear(Rows, Limits, Cost, relaxed, OutSolution))
+            return false;
+        OutBound = fixedTotal + relaxed;
+        return true;
+    }
+
+    bool IsBoundedOut(double InBound) const
+    {
+        return InBound > static_cast<double>(Best) - 1.0 + 1e-6;
+    }
+
+    // InRelaxed is the relaxed optimum of the free buttons from InFree on
+    void Search(size_t InFree, const std::vector<double>& InRelaxed)
+    {
+        if (InFree + 1 == Presses.size())
+        {
+            SearchLast(InFree);
+            return;
+        }
+        // Upwards from just above the relaxed optimum, then downwards from just below it
+        const int64_t limit = System.FreeLimits[InFree];
+        const int64_t start = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(InRelaxed[0] - 1e-9)), 0, limit);
+        for (int64_t count = start; count <= limit; ++count)
+        {
+            if (!SearchChild(InFree, count))
+                break;
+        }
+        for (int64_t count = start - 1; count >= 0; --count)
+        {
+            if (!SearchChild(InFree, count))
+                break;
+        }
+    }
+
+    // False when the child is infeasible or bounded out, and with it every child further out
+    bool SearchChild(size_t InFree, int64_t InCount)
+    {
+        Press(InFree, InCount);
+        double bound = 0.0;
+        std::vector<double> relaxed;
+        const bool bIsWorthSearching = GetRelaxedBound(InFree + 1, bound, relaxed) && !IsBoundedOut(bound);
+        if (bIsWorthSearching)
+            Search(InFree + 1, relaxed);
+        Press(InFree, -InCount);
+        return bIsWorthSearching;
+    }
+
+    void SearchLast(size_t InFree)
+    {
+        int64_t low = 0;
+        int64_t high = System.FreeLimits[InFree];
+        for (size_t pivot = 0; pivot < Remainders.size() && low <= high; ++pivot)
+        {
+            // 0 <= Remainder - Coefficient * presses
+            const int64_t coefficient = System.Coefficients[pivot][InFree];
+            if (coefficient > 0)
+                high = std::min(high, FloorDivide(Remainders[pivot], coefficient));
+            else if (coefficient < 0)
+                low = std::max(low, CeilDivide(Remainders[pivot], coefficient));
+            else if (Remainders[pivot] < 0)
+                return;
+        }
+        const bool bIsUpwards = System.FreeWeights[InFree] >= 0.0;
+        for (int64_t step = 0; step <= high - low; ++step)
+        {
+            const int64_t count = bIsUpwards ? low + step : high - step;
+            Press(InFree, count);
+            int64_t pivotTotal = 0;
+            const bool bIsWhole = GetPivotTotal(pivotTotal);
+            const int64_t total = FreeTotal + pivotTotal;
+            Press(InFree, -count);
+            if (bIsWhole)
+            {
+                Best = std::min(Best, total);
+                break;
+            }
+        }
+    }
+
+    const FJoltageSystem& System;
+    std::vector<int64_t> Remainders;
+    std::vector<int64_t> Presses;
+    int64_t FreeTotal = 0;
+    int64_t Best = std::numeric_limits<int64_t>::max();
+    std::vector<std::vector<double>> Rows;
+    std::vector<double> Limits;
+    std::vector<double> Cost;
+};
+
+// Fewest presses bringing every counter to its joltage, 0 when no combination does
 int64_t FindSmallestButtonComboPart2(const std::vector<Machine>::value_type& machine)
 {
-    std::vector<int32_t> input(machine.JOltageRequirements.size(), 0);
-    Eigen::MatrixXd A(6,5);
-    
-    return 0;
+    const FJoltageSystem system = MakeJoltageSystem(machine);
+    return FJoltageSearch(system).Run();
 }
 
-void Day12(const std::string& InFileName, const int64_t InPart1Expected, const int64_t InPart2Expected)
+std::vector<Machine> Parse(const std::string& InFileName)
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    int64_t part1Count = 0;
-    int64_t part2Count = 0;
+    Aoc::FMappedFile inputFile(InFileName);
+    Aoc::FLineReader lineReader(inputFile.GetContents());
+    std::string_view inputLine;
     std::vector<Machine> machines;
     
-    while (inputFile.is_open() && !inputFile.eof())
+    while (lineReader.Next(inputLine))
     {
         Machine newMachine;
-        std::getline(inputFile, inputLine);
-        std::regex e(R"(\[([^\]]*)\])");
-        
-        std::smatch match;
-        if (std::regex_search(inputLine, match, e))
-        {
-            newMachine.Lights = match[1];
-        }
-        
-        std::regex e2(R"(\([\d,]+\))");
-        std::sregex_iterator iter2(inputLine.begin(), inputLine.end(), e2);
-        std::sregex_iterator end;
-        if (iter2 == end)
-            continue;
-        for (std::sregex_iterator subitr = iter2; subitr != end; ++subitr)
+        const size_t lightsBegin = inputLine.find('[');
+        const size_t lightsEnd = inputLine.find(']', lightsBegin);
+        if (lightsBegin != std::string_view::npos && lightsEnd != std::string_view::npos)
         {
-            std::regex e3(R"(\d+)");
-            std::string searchString = subitr->str();
-            std::sregex_iterator iter3(searchString.begin(), searchString.end(), e3);
-            if (iter3 == end)
-                continue;
-            
-            std::vector<int32_t> buttonActions;
-            for (std::sregex_iterator subitr2 = iter3; subitr2 != end; ++subitr2)
+            newMachine.Lights = std::string(inputLine.substr(lightsBegin + 1, lightsEnd - lightsBegin - 1));
+            for (size_t light = 0; light < newMachine.Lights.size() && light < 64; ++light)
             {
-                std::string valueString = subitr2->str();
-                if (!valueString.empty())
-                    buttonActions.emplace_back(std::atoi(subitr2->str().c_str()));
+                if (newMachine.Lights[light] == '#')
+                    newMachine.LightMask |= 1ull << light;
             }
-            if (!buttonActions.empty())
-                newMachine.Buttons.emplace_back(buttonActions);
-        }
-        std::regex e4(R"(\{([\d,]+)\})");
-        std::sregex_iterator iter4(inputLine.begin(), inputLine.end(), e4);
-        if (std::regex_search(inputLine, match, e4)) {
-            std::string inside = match[1]; // "3,5,4,7"
-            std::stringstream ss(inside);
-            std::string token;
-
-            while (std::getline(ss, token, ',')) {
-                newMachine.JOltageRequirements.emplace_back(std::stoi(token));
+        }
+
+        std::vector<int64_t> values;
+        size_t groupBegin = inputLine.find('(');
+        while (groupBegin != std::string_view::npos)
+        {
+            const size_t groupEnd = inputLine.find(')', groupBegin);
+            if (groupEnd == std::string_view::npos)
+                break;
+            values.clear();
+            Aoc::AppendIntegers(inputLine.substr(groupBegin + 1, groupEnd - groupBegin - 1), values);
+            if (!values.empty())
+            {
+                newMachine.Buttons.emplace_back(values.begin(), values.end());
+                uint64_t buttonMask = 0;
+                for (int64_t light : values)
+                {
+                    if (light >= 0 && light < 64)
+                        buttonMask |= 1ull << light;
+                }
+                newMachine.ButtonMasks.push_back(buttonMask);
             }
+            groupBegin = inputLine.find('(', groupEnd);
+        }
+        if (newMachine.Buttons.empty())
+            continue;
+
+        const size_t joltageBegin = inputLine.find('{');
+        const size_t joltageEnd = inputLine.find('}', joltageBegin);
+        if (joltageBegin != std::string_view::npos && joltageEnd != std::string_view::npos)
+        {
+            values.clear();
+            Aoc::AppendIntegers(inputLine.substr(joltageBegin + 1, joltageEnd - joltageBegin - 1), values);
+            newMachine.JOltageRequirements.assign(values.begin(), values.end());
         }
         machines.emplace_back(newMachine);
     }
     
-    auto start = std::chrono::high_resolution_clock::now();
-    part1Count = 0;
-    for (const auto& machine : machines)
+    return machines;
+}
+
+int64_t SolvePart1(const std::vector<Machine>& InMachines)
+{
+    int64_t part1Count = 0;
+    for (const auto& machine : InMachines)
     {
-        part1Count += FindSmallestButtonCombo(machine);
-        part2Count += FindSmallestButtonComboPart2(machine);
+        if (machine.Lights.size() > 64)
+        {
+            std::fprintf(stderr, "Day 10: a machine with %zu lights is over the limit of 64\n", machine.Lights.size());
+            continue;
+        }
+        part1Count += FindFewestPresses(machine.LightMask, machine.ButtonMasks);
     }
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part1Count == InPart1Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part2Count == InPart2Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
+    return part1Count;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+// Breadth first search over the light strings
+int64_t SolvePart1Bfs(const std::vector<Machine>& InMachines)
 {
-    Day12("TestInput.txt", 7, 33);
-    Day12("Input.txt", 535,1572047142);
-    return 0;
+    int64_t part1Count = 0;
+    for (const auto& machine : InMachines)
+        part1Count += FindSmallestButtonCombo(machine);
+    return part1Count;
+}
+
+int64_t SolvePart2(const std::vector<Machine>& InMachines)
+{
+    int64_t part2Count = 0;
+    for (const auto& machine : InMachines)
+        part2Count += FindSmallestButtonComboPart2(machine);
+    return part2Count;
+}
+
+static const Aoc::TDayRegistrar Registrar(10, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day10/TestInput.txt", 7, 33},
+    {"Day10/Input.txt", 535, std::nullopt},
+});
+static const Aoc::TVariantRegistrar BfsPart1(10, 1, "bfs", &SolvePart1Bfs);
+
 }
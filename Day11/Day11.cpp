@@ -1,24 +1,31 @@
-#include <chrono>
-#include <fstream>
 #include <iostream>
 #include <map>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "Harness.h"
+#include "Input.h"
 
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
+namespace Day11
+{
 
 struct Machine
 {
-    std::vector<std::string> Connections;
+    std::vector<std::string_view> Connections;
     std::vector<int32_t> FastConnections;
-    std::string Id;
+    std::string_view Id;
 };
 
-int64_t FindPaths(const std::string& InFrom, const std::string& InTarget,
-    const std::vector<Machine>& InMachines, std::map<std::string, int32_t>& InOutCache)
+// The ids point into the mapped input
+struct FDeviceList
+{
+    Aoc::FMappedFile File;
+    std::vector<Machine> Machines;
+};
+
+int64_t FindPaths(std::string_view InFrom, std::string_view InTarget,
+    const std::vector<Machine>& InMachines, std::map<std::string_view, int32_t>& InOutCache)
 {
     int64_t returnCount = 0;
     if (InFrom == "out")
@@ -48,65 +55,56 @@ int64_t FindPaths(const std::string& InFrom, const std::string& InTarget,
     return returnCount;
 }
 
-int64_t FindPathsWithCache(const std::string& InFrom,
-                                const std::string& InGoal,
+int64_t FindPathsWithCache(std::string_view InFrom,
+                                std::string_view InGoal,
                                 const std::vector<Machine>& InMachines)
 {
-    std::map<std::string, int32_t> cache;
+    std::map<std::string_view, int32_t> cache;
     return FindPaths(InFrom, InGoal, InMachines, cache);
 }
 
-void Day12(const std::string& InFileName, const int64_t InPart1Expected, const int64_t InPart2Expected)
+FDeviceList Parse(const std::string& InFileName)
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    int64_t part1Count = 0;
-    int64_t part2Count = 0;
-    
-    std::vector<Machine> machines;
+    FDeviceList devices;
+    devices.File = Aoc::FMappedFile(InFileName);
+    Aoc::FLineReader lineReader(devices.File.GetContents());
+    std::string_view inputLine;
     
-    while (inputFile.is_open() && !inputFile.eof())
+    while (lineReader.Next(inputLine))
     {
+        const size_t separator = inputLine.find(':');
+        if (separator == std::string_view::npos)
+            continue;
         Machine machine;
-        std::getline(inputFile, machine.Id, ':');
-        std::getline(inputFile, inputLine);
-        std::stringstream ss(inputLine);
-        std::string token;
-
-        while (std::getline(ss, token, ' ')) {
-            if (!token.empty())
-                machine.Connections.emplace_back(token);
-        }
-        machines.emplace_back(machine);
+        machine.Id = inputLine.substr(0, separator);
+        machine.Connections = Aoc::SplitFields(inputLine.substr(separator + 1), " ");
+        devices.Machines.emplace_back(std::move(machine));
     }
     
-    auto start = std::chrono::high_resolution_clock::now();
-    int32_t startId = -1;
-    
-    part1Count = FindPathsWithCache("you", "out", machines);
-    std::map<std::string, int32_t> a;
-    int64_t fftToDac = FindPathsWithCache("svr", "fft", machines)
-        * FindPathsWithCache("fft", "dac", machines)
-        * FindPathsWithCache("dac", "out", machines);
-    int64_t dactoFFT = FindPathsWithCache("svr", "dac", machines)
-        * FindPathsWithCache("dac", "fft", machines)
-        * FindPathsWithCache("fft", "out", machines);
-    
-    part2Count = fftToDac + dactoFFT;
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part1Count == InPart1Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part2Count == InPart2Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
+    return devices;
+}
+
+int64_t SolvePart1(const FDeviceList& InDevices)
+{
+    return FindPathsWithCache("you", "out", InDevices.Machines);
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+int64_t SolvePart2(const FDeviceList& InDevices)
 {
-    Day12("TestInput.txt", 0, 2); // Part 1 breaks with new Test Input
-    Day12("Input.txt", 772,423227545768872);
-    return 0;
+    const std::vector<Machine>& InMachines = InDevices.Machines;
+    int64_t fftToDac = FindPathsWithCache("svr", "fft", InMachines)
+        * FindPathsWithCache("fft", "dac", InMachines)
+        * FindPathsWithCache("dac", "out", InMachines);
+    int64_t dactoFFT = FindPathsWithCache("svr", "dac", InMachines)
+        * FindPathsWithCache("dac", "fft", InMachines)
+        * FindPathsWithCache("fft", "out", InMachines);
+    
+    return fftToDac + dactoFFT;
+}
+
+static const Aoc::TDayRegistrar Registrar(11, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day11/TestInput.txt", 0, 2}, // Part 1 breaks with new Test Input
+    {"Day11/Input.txt", 772, 423227545768872},
+});
+
 }
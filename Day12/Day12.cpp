@@ -1,25 +1,25 @@
 #include <algorithm>
 #include <array>
 #include <bitset>
-#include <chrono>
-#include <fstream>
+#include <climits>
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 #include <numeric>
 #include <thread>
 #include <core/Solver.h> // glucose
 
-namespace std
+#include "Harness.h"
+#include "Input.h"
+#include "IntegerParser.h"
+
+namespace Day12
 {
-    class thread;
-}
 
 using namespace std;
-const char* ANSI_BOLD_UNDERLINE ="\033[1m\033[4m";
-const char* ANSI_RESET = "\033[0m";
 
 
 /*
@@ -420,48 +420,54 @@ bool HasMatchSat(const std::vector<Shape>& shapes,
     return true;
 }
 
-void Day12(const std::string& InFileName, const int64_t InPart1Expected, const int64_t InPart2Expected)
+struct FPresentPuzzle
+{
+    vector<Shape> Shapes;
+    vector<ConstraintToEvaluate> EvaluateBoxes;
+};
+
+FPresentPuzzle Parse(const std::string& InFileName)
 {
-    std::printf("Result for %s\n", InFileName.c_str());
-    std::ifstream inputFile;
-    inputFile.open(InFileName);
-    std::string inputLine;
-    vector<Shape> shapes;
-    vector<ConstraintToEvaluate> evaluateBoxes;
-    while (inputFile.is_open() && !inputFile.eof())
+    Aoc::FMappedFile inputFile(InFileName);
+    Aoc::FLineReader lineReader(inputFile.GetContents());
+    std::string_view inputLine;
+    FPresentPuzzle puzzle;
+    while (lineReader.Next(inputLine))
     {
-        std::getline(inputFile, inputLine);
         if (inputLine.empty())
             continue;
         else if (inputLine[inputLine.length() - 1] == ':')
         {
-            std::string l1, l2, l3;
-            std::getline(inputFile, l1);
-            std::getline(inputFile, l2);
-            std::getline(inputFile, l3);
-            shapes.emplace_back(make_shape_from_ascii({
-                l1, l2, l3
-            }, inputLine.substr(0, inputLine.length() - 2)));
+            std::string_view l1, l2, l3;
+            lineReader.Next(l1);
+            lineReader.Next(l2);
+            lineReader.Next(l3);
+            puzzle.Shapes.emplace_back(make_shape_from_ascii({
+                string(l1), string(l2), string(l3)
+            }, string(inputLine.substr(0, inputLine.length() - 2))));
         }
         else if (!inputLine.empty())
         {
             ConstraintToEvaluate constraint;
-            stringstream ss(inputLine);
-            char delim;
-            ss >> constraint.W >>delim >> constraint.H >> delim;
-            int count;
-            while (ss.peek() != EOF)
-            {
-                ss >> count;
-                constraint.CountTargets.emplace_back(count);
-            }
-            evaluateBoxes.emplace_back(constraint);
+            vector<int64_t> values;
+            Aoc::AppendIntegers(inputLine, values);
+            if (values.size() < 2)
+                continue;
+            constraint.W = static_cast<int>(values[0]);
+            constraint.H = static_cast<int>(values[1]);
+            for (size_t valueIndex = 2; valueIndex < values.size(); ++valueIndex)
+                constraint.CountTargets.emplace_back(static_cast<int>(values[valueIndex]));
+            puzzle.EvaluateBoxes.emplace_back(constraint);
         }
     }
     
-    auto start = std::chrono::high_resolution_clock::now();
+    return puzzle;
+}
+
+int64_t SolvePart1(const FPresentPuzzle& InPuzzle)
+{
     int64_t part1Count = 0;
-    for (auto constraint : evaluateBoxes)
+    for (const auto& constraint : InPuzzle.EvaluateBoxes)
     {
         int64_t shapeCount = 0;
         for (int countTarget : constraint.CountTargets)
@@ -472,19 +478,18 @@ void Day12(const std::string& InFileName, const int64_t InPart1Expected, const i
             part1Count++;
     }
     
-    int64_t part2Count = 0;
-
-    auto end = std::chrono::high_resolution_clock::now();
-    std::printf("Result part 1: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part1Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part1Count == InPart1Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::printf("Result part 2: %s%lld%s which is %s%s%s\n",
-        ANSI_BOLD_UNDERLINE, part2Count, ANSI_RESET, ANSI_BOLD_UNDERLINE, part2Count == InPart2Expected ? "Correct" : "Incorrect", ANSI_RESET);
-    std::cout << "Execution time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "μs" << std::endl;
+    return part1Count;
 }
 
-int main(int /*InArgc*/, char* /*InArgv[]*/)
+int64_t SolvePart2(const FPresentPuzzle& /*InPuzzle*/)
 {
-    Day12("TestInput.txt", 2, 2); // Part 1 breaks with new Test Input
-    Day12("Input.txt", 772,423227545768872);
-    return 0;
+    int64_t part2Count = 0;
+    return part2Count;
+}
+
+static const Aoc::TDayRegistrar Registrar(12, &Parse, &SolvePart1, &SolvePart2, {
+    {"Day12/TestInput.txt", 2, std::nullopt},
+    {"Day12/Input.txt", std::nullopt, std::nullopt},
+});
+
 }